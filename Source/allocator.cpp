@@ -0,0 +1,211 @@
+#include "allocator.hpp"
+
+#include "dynamicConfig.hpp"
+#include "logging.hpp"
+
+#if defined(__linux__) && !defined(__ANDROID__)
+#define WITH_LINUX_ALLOCATOR
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace {
+constexpr size_t hugePageSize = 2ull * 1024ull * 1024ull;
+bool hugePagesAvailable = false;
+std::vector<int> nodeIds;               // NUMA nodes having cpus
+std::vector<std::vector<int>> nodeCpus; // cpus of each of those nodes
+std::vector<int> allCpus;               // all cpus, node by node
+
+#ifdef WITH_LINUX_ALLOCATOR
+[[nodiscard]] std::string readLine(const std::string& fileName) {
+   std::ifstream str(fileName);
+   std::string line;
+   if (str) std::getline(str, line);
+   return line;
+}
+
+// parse a sysfs list like "0-3,8-11"
+[[nodiscard]] std::vector<int> parseList(const std::string& s) {
+   std::vector<int> ret;
+   for (const auto& range : tokenize(trim(s), ",")) {
+      const auto bounds = tokenize(range, "-");
+      if (bounds.empty() || bounds[0].empty()) continue;
+      const int first = std::atoi(bounds[0].c_str());
+      const int last  = bounds.size() > 1 ? std::atoi(bounds[1].c_str()) : first;
+      for (int k = first; k <= last; ++k) ret.push_back(k);
+   }
+   return ret;
+}
+
+// interleave pages of [ptr, ptr+size) on all nodes (must be called before first touch)
+void interleave(void* ptr, const size_t size) {
+   constexpr int MPOL_INTERLEAVE_ = 3; // from numaif.h, not included to avoid libnuma dependency
+   constexpr size_t maskBits = 1024;
+   array1d<unsigned long, maskBits / (8 * sizeof(unsigned long))> mask = {0};
+   for (const auto n : nodeIds) {
+      if (static_cast<size_t>(n) < maskBits) mask[n / (8 * sizeof(unsigned long))] |= 1ul << (n % (8 * sizeof(unsigned long)));
+   }
+   if (syscall(SYS_mbind, ptr, size, MPOL_INTERLEAVE_, mask.data(), maskBits, 0) != 0) {
+      Logging::LogIt(Logging::logWarn) << "mbind failed, NUMA interleave not applied";
+   }
+}
+#endif
+} // namespace
+
+namespace Allocator {
+
+void init() {
+#ifdef WITH_LINUX_ALLOCATOR
+   const std::string thp = readLine("/sys/kernel/mm/transparent_hugepage/enabled");
+   hugePagesAvailable    = thp.find("[always]") != std::string::npos || thp.find("[madvise]") != std::string::npos;
+   nodeIds.clear();
+   nodeCpus.clear();
+   for (const auto n : parseList(readLine("/sys/devices/system/node/online"))) {
+      const auto cpus = parseList(readLine("/sys/devices/system/node/node" + std::to_string(n) + "/cpulist"));
+      if (cpus.empty()) continue; // memory only node
+      nodeIds.push_back(n);
+      nodeCpus.push_back(cpus);
+   }
+   allCpus.clear();
+   for (const auto& cpus : nodeCpus) allCpus.insert(allCpus.end(), cpus.begin(), cpus.end());
+   if (allCpus.empty()) {
+      for (int c = 0; c < static_cast<int>(std::thread::hardware_concurrency()); ++c) allCpus.push_back(c);
+   }
+#endif
+   Logging::LogIt(Logging::logInfo) << "Memory allocation mode: " << mode();
+}
+
+NumaPolicy numaPolicy() {
+   if (DynamicConfig::numaPolicy == "interleave") return NP_interleave;
+   if (DynamicConfig::numaPolicy == "firstTouch") return NP_firstTouch;
+   return NP_none;
+}
+
+size_t nbNodes() { return std::max(size_t(1), nodeIds.size()); }
+
+std::string mode() {
+   std::string ret = (DynamicConfig::largePages && hugePagesAvailable) ? "huge pages (madvise)" : "standard pages";
+   if (nbNodes() > 1) {
+      switch (numaPolicy()) {
+         case NP_interleave:  ret += ", NUMA interleave"; break;
+         case NP_firstTouch:  ret += ", NUMA first touch"; break;
+         case NP_none:
+         default:             ret += ", no NUMA policy"; break;
+      }
+   }
+   return ret + " (" + std::to_string(nbNodes()) + " node(s))";
+}
+
+void* alloc(const size_t size) {
+#ifdef WITH_LINUX_ALLOCATOR
+   const bool useHugePages  = DynamicConfig::largePages && hugePagesAvailable;
+   const bool useInterleave = numaPolicy() == NP_interleave && nbNodes() > 1;
+   if (useHugePages || useInterleave) {
+      // aligned on huge page size, and size is a multiple of it
+      const size_t alignedSize = ((size + hugePageSize - 1) / hugePageSize) * hugePageSize;
+      if (void* ret = std::aligned_alloc(hugePageSize, alignedSize); ret) {
+         if (useHugePages && madvise(ret, alignedSize, MADV_HUGEPAGE) != 0) {
+            Logging::LogIt(Logging::logWarn) << "madvise failed, huge pages not used";
+         }
+         if (useInterleave) interleave(ret, alignedSize);
+         return ret;
+      }
+      Logging::LogIt(Logging::logWarn) << "Huge page aligned allocation failed, falling back to standard allocation";
+   }
+#endif
+   return std_aligned_alloc(1024, size);
+}
+
+void bindCurrentThreadToNode([[maybe_unused]] const size_t node) {
+#ifdef WITH_LINUX_ALLOCATOR
+   if (nodeCpus.size() < 2) return;
+   cpu_set_t set;
+   CPU_ZERO(&set);
+   for (const auto c : nodeCpus[node % nodeCpus.size()]) CPU_SET(c, &set);
+   if (sched_setaffinity(0, sizeof(cpu_set_t), &set) != 0) {
+      Logging::LogIt(Logging::logWarn) << "Cannot bind thread to node " << node;
+   }
+#endif
+}
+
+ThreadBinding threadBinding() {
+   if (DynamicConfig::threadBinding == "cores") return TB_cores;
+   if (DynamicConfig::threadBinding == "nodes") return TB_nodes;
+   return TB_none;
+}
+
+size_t nodeOfThread([[maybe_unused]] const size_t threadId, [[maybe_unused]] const size_t nbThreads) {
+#ifdef WITH_LINUX_ALLOCATOR
+   switch (threadBinding()) {
+      case TB_cores:
+         if (!allCpus.empty()) {
+            const int cpu = allCpus[threadId % allCpus.size()];
+            for (size_t n = 0; n < nodeCpus.size(); ++n) {
+               if (std::find(nodeCpus[n].begin(), nodeCpus[n].end(), cpu) != nodeCpus[n].end()) return n;
+            }
+         }
+         return 0;
+      case TB_nodes: return (threadId % std::max(size_t(1), nbThreads)) * nbNodes() / std::max(size_t(1), nbThreads);
+      case TB_none:
+      default: return 0;
+   }
+#else
+   return 0;
+#endif
+}
+
+void bindSearchThread([[maybe_unused]] const size_t threadId, [[maybe_unused]] const size_t nbThreads) {
+#ifdef WITH_LINUX_ALLOCATOR
+   switch (threadBinding()) {
+      case TB_cores: {
+         if (allCpus.empty()) return;
+         const int cpu = allCpus[threadId % allCpus.size()];
+         cpu_set_t set;
+         CPU_ZERO(&set);
+         CPU_SET(cpu, &set);
+         if (sched_setaffinity(0, sizeof(cpu_set_t), &set) != 0) {
+            Logging::LogIt(Logging::logWarn) << "Cannot bind thread " << threadId << " to cpu " << cpu;
+            return;
+         }
+         Logging::LogIt(Logging::logInfo) << "Thread " << threadId << " bound to cpu " << cpu;
+         break;
+      }
+      case TB_nodes: {
+         const size_t node = nodeOfThread(threadId, nbThreads);
+         bindCurrentThreadToNode(node);
+         Logging::LogIt(Logging::logInfo) << "Thread " << threadId << " bound to node " << node;
+         break;
+      }
+      case TB_none:
+      default: break;
+   }
+#endif
+}
+
+void* allocOnNode(const size_t size, [[maybe_unused]] const size_t node) {
+#ifdef WITH_LINUX_ALLOCATOR
+   if (nodeIds.size() > 1) {
+      const size_t pageSize    = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+      const size_t alignedSize = ((size + pageSize - 1) / pageSize) * pageSize;
+      const int    n           = nodeIds[node % nodeIds.size()];
+      if (void* ret = std::aligned_alloc(pageSize, alignedSize); ret) {
+         constexpr int MPOL_BIND_ = 2; // from numaif.h, not included to avoid libnuma dependency
+         constexpr size_t maskBits = 1024;
+         array1d<unsigned long, maskBits / (8 * sizeof(unsigned long))> mask = {0};
+         if (static_cast<size_t>(n) < maskBits) {
+            mask[n / (8 * sizeof(unsigned long))] |= 1ul << (n % (8 * sizeof(unsigned long)));
+            // pages are not touched yet, so that they will be allocated on the node by first touch
+            if (syscall(SYS_mbind, ret, alignedSize, MPOL_BIND_, mask.data(), maskBits, 0) != 0) {
+               Logging::LogIt(Logging::logWarn) << "mbind failed, memory not bound to node " << n;
+            }
+         }
+         return ret;
+      }
+   }
+#endif
+   return std_aligned_alloc(64, size);
+}
+
+} // namespace Allocator
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "definition.hpp"
+#include "tools.hpp"
+
+/*!
+ * Allocation layer for the big shared tables (TT and pawn tables)
+ * On Linux, memory is aligned on 2Mb and transparent huge pages are requested with madvise
+ * to reduce TLB misses. NUMA placement can be interleaved over all nodes or left to first touch,
+ * in which case zeroing threads are bound to the node that shall own each chunk.
+ * Everything falls back to std_aligned_alloc if not available.
+ * Memory returned by Allocator::alloc shall be released using std_aligned_free.
+ */
+namespace Allocator {
+
+enum NumaPolicy : uint8_t { NP_none = 0, NP_interleave, NP_firstTouch };
+
+// detect huge pages availability and NUMA topology, and report active mode
+void init();
+
+[[nodiscard]] NumaPolicy numaPolicy();
+
+[[nodiscard]] size_t nbNodes();
+
+// human readable active mode
+[[nodiscard]] std::string mode();
+
+[[nodiscard]] void* alloc(const size_t size);
+
+template<class T> struct DeleteAligned {
+   void operator()(T *ptr) const {
+      if (ptr) std_aligned_free(ptr);
+   }
+};
+
+// bind calling thread to the cpus of the given node (no-op on a single node machine)
+void bindCurrentThreadToNode(const size_t node);
+
+// search threads binding (see ThreadBinding option): none, one thread per core, or threads spread by blocks over NUMA nodes
+enum ThreadBinding : uint8_t { TB_none = 0, TB_cores, TB_nodes };
+
+[[nodiscard]] ThreadBinding threadBinding();
+
+// node owning the given search thread once bound
+[[nodiscard]] size_t nodeOfThread(const size_t threadId, const size_t nbThreads);
+
+// bind calling search thread following ThreadBinding option (no-op if none)
+void bindSearchThread(const size_t threadId, const size_t nbThreads);
+
+// allocate memory bound to the given node before it is touched (no binding on a single node machine),
+// to be released using std_aligned_free
+[[nodiscard]] void* allocOnNode(const size_t size, const size_t node);
+
+// zero (using value) a table using nbThreads threads,
+// with first touch policy each thread is bound to the node that will own its chunk
+template<typename T> void clear(T* table, const uint64_t size, const size_t nbThreads, const T& value) {
+   const bool firstTouch = numaPolicy() == NP_firstTouch && nbNodes() > 1;
+   auto worker = [&](size_t begin, size_t end) {
+      if (firstTouch) bindCurrentThreadToNode(begin * nbNodes() / size);
+      std::fill(table + begin, table + end, value);
+   };
+   threadedWork(worker, std::max(nbThreads, firstTouch ? nbNodes() : size_t(1)), size);
+}
+
+} // namespace Allocator
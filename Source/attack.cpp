@@ -252,8 +252,11 @@ void initMagic() {
 #endif // MAGIC
 
 bool isAttackedBB(const Position &p, const Square s, const Color c) { ///@todo try to optimize order better ?
+   return isAttackedBB(p, s, c, p.occupancy());
+}
+
+bool isAttackedBB(const Position &p, const Square s, const Color c, const BitBoard occupancy) {
    assert(isValidSquare(s));
-   const BitBoard occupancy = p.occupancy();
    if (c == Co_White)
       return attack<P_wb>(s, p.blackBishop() | p.blackQueen(), occupancy) ||
              attack<P_wr>(s, p.blackRook() | p.blackQueen(), occupancy) ||
@@ -268,6 +271,16 @@ bool isAttackedBB(const Position &p, const Square s, const Color c) { ///@todo t
              attack<P_wk>(s, p.whiteKing());
 }
 
+BitBoard attackedSet(const Position &p, const Color c, const BitBoard occupancy) {
+   const Color opp = ~c;
+   BitBoard att = coverageSet<P_wb>(p.pieces_const<P_wb>(opp) | p.pieces_const<P_wq>(opp), occupancy) |
+                  coverageSet<P_wr>(p.pieces_const<P_wr>(opp) | p.pieces_const<P_wq>(opp), occupancy) |
+                  (opp == Co_White ? pawnAttacks<Co_White>(p.pieces_const<P_wp>(opp)) : pawnAttacks<Co_Black>(p.pieces_const<P_wp>(opp)));
+   BB::applyOn(p.pieces_const<P_wn>(opp), [&](const Square & k) { att |= mask[k].knight; });
+   BB::applyOn(p.pieces_const<P_wk>(opp), [&](const Square & k) { att |= mask[k].king; });
+   return att;
+}
+
 BitBoard allAttackedBB(const Position &p, const Square s, const Color c) {
    assert(isValidSquare(s));
    const BitBoard occupancy = p.occupancy();
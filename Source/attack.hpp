@@ -1,9 +1,10 @@
 #pragma once
 
 #include "bitboardTools.hpp"
+#include "cpu.hpp"
 #include "definition.hpp"
 
-#ifdef __BMI2__
+#if defined(__BMI2__) || defined(__AVX2__) || defined(WITH_CPU_DISPATCH)
 #include <immintrin.h>
 #endif
 
@@ -13,6 +14,7 @@ namespace BBTools {
  * Two bitboard attack generation tools can be used here (controlled by WITH_MAGIC define from config.hpp):
  * - hyperbola quintessence (https://www.chessprogramming.org/Hyperbola_Quintessence)
  * - or magic (https://www.chessprogramming.org/Magic_Bitboards) with BMI2 extension if available
+ * A third, set-wise, one (Kogge-Stone fills, see coverageSet) gives attacks of a whole set of sliders at once.
  */
 
 // mask variable is filled with many usefull pre-computed bitboard information
@@ -97,7 +99,16 @@ extern array1d<SMagic, NbSquare> rookMagic;
 extern array2d<BitBoard, NbSquare, 1 << BISHOP_INDEX_BITS> bishopAttacks;
 extern array2d<BitBoard, NbSquare, 1 << ROOK_INDEX_BITS> rookAttacks;
 
-#if defined(__BMI2__) && !defined(__znver1) && !defined(__znver2) && !defined(__bdver4) && defined(ENV64BIT)
+#if defined(WITH_CPU_DISPATCH)
+// generic build, pext is used only if available and fast (see CPU::init), index choice cannot change after initMagic
+FORCE_FINLINE uint64_t pext(const BitBoard m, const BitBoard mask) {
+   uint64_t r;
+   __asm__("pextq %2, %1, %0" : "=r"(r) : "r"(m), "rm"(mask));
+   return r;
+}
+inline auto MAGICBISHOPINDEX(const BitBoard m, const Square x) { return CPU::features.fastPext ? static_cast<int>(pext(m, MagicBB::bishopMagic[x].mask)) : static_cast<int>(((m & MagicBB::bishopMagic[x].mask) * MagicBB::bishopMagic[x].magic) >> (NbSquare - BISHOP_INDEX_BITS));}
+inline auto MAGICROOKINDEX(const BitBoard m, const Square x)   { return CPU::features.fastPext ? static_cast<int>(pext(m, MagicBB::rookMagic[x].mask))   : static_cast<int>(((m & MagicBB::rookMagic[x].mask) * MagicBB::rookMagic[x].magic) >> (NbSquare - ROOK_INDEX_BITS));}
+#elif defined(__BMI2__) && !defined(__znver1) && !defined(__znver2) && !defined(__bdver4) && defined(ENV64BIT)
 inline auto MAGICBISHOPINDEX(const BitBoard m, const Square x) { return _pext_u64(m, MagicBB::bishopMagic[x].mask);}
 inline auto MAGICROOKINDEX(const BitBoard m, const Square x)    { return _pext_u64(m, MagicBB::rookMagic[x].mask);}
 #else
@@ -140,13 +151,202 @@ constexpr BitBoard (*const pfCoverage[])(const Square, const BitBoard, const Col
                                                                                        &BBTools::coverage<P_wq>, &BBTools::coverage<P_wk>};
 //constexpr BitBoard(*const pfAttack[])  (const Square, const BitBoard, const BitBoard, const Color) = { &BBTools::attack<P_wp>,   &BBTools::attack<P_wn>,   &BBTools::attack<P_wb>,   &BBTools::attack<P_wr>,   &BBTools::attack<P_wq>,   &BBTools::attack<P_wk>   };
 
+/*!
+ * Set-wise slider attacks : all pieces of a set are handled at once using Kogge-Stone occluded fills
+ * (https://www.chessprogramming.org/Kogge-Stone_Algorithm). With AVX2, the four directions of
+ * a bishop (or a rook) are filled together in one 256 bits register, one direction per lane.
+ * This is used when only the union of the attacks is needed (threats) or a sum over pieces (mobility).
+ */
+namespace SetWise {
+
+// directions are two "up" shifts (<<) then two "down" shifts (>>), wrap is the mask against file wrapping
+template<Piece> struct Dir;
+template<> struct Dir<P_wb> { // NE NW SE SW
+   static constexpr array1d<int,4>      shift = {9, 7, 7, 9};
+   static constexpr array1d<BitBoard,4> wrap  = {~BB::fileA, ~BB::fileH, ~BB::fileA, ~BB::fileH};
+};
+template<> struct Dir<P_wr> { // N E S W
+   static constexpr array1d<int,4>      shift = {8, 1, 8, 1};
+   static constexpr array1d<BitBoard,4> wrap  = {~emptyBitBoard, ~BB::fileA, ~emptyBitBoard, ~BB::fileH};
+};
+
+template<bool up> [[nodiscard]] constexpr BitBoard shift(const BitBoard b, const int s) { return up ? b << s : b >> s; }
+
+template<bool up> [[nodiscard]] constexpr BitBoard occludedFill(BitBoard gen, BitBoard pro, const int s, const BitBoard wrap) {
+   pro &= wrap;
+   gen |= pro & shift<up>(gen, s);
+   pro &=       shift<up>(pro, s);
+   gen |= pro & shift<up>(gen, 2 * s);
+   pro &=       shift<up>(pro, 2 * s);
+   gen |= pro & shift<up>(gen, 4 * s);
+   return shift<up>(gen, s) & wrap;
+}
+
+// attacks of the set in each direction
+template<Piece pp> [[nodiscard]] constexpr array1d<BitBoard,4> rays(const BitBoard pieces, const BitBoard occupancy) {
+   using D = Dir<pp>;
+   return {occludedFill<true >(pieces, ~occupancy, D::shift[0], D::wrap[0]), occludedFill<true >(pieces, ~occupancy, D::shift[1], D::wrap[1]),
+           occludedFill<false>(pieces, ~occupancy, D::shift[2], D::wrap[2]), occludedFill<false>(pieces, ~occupancy, D::shift[3], D::wrap[3])};
+}
+
+#if defined(__AVX2__) || defined(WITH_CPU_DISPATCH)
+#define WITH_SETWISE_AVX2
+// with WITH_CPU_DISPATCH the kernels are built for avx2 and only called if CPU::features.avx2
+#if defined(WITH_CPU_DISPATCH) && !defined(__AVX2__)
+#define SETWISE_TARGET __attribute__((target("avx2")))
+#define SETWISE_INLINE inline
+#else
+#define SETWISE_TARGET
+#define SETWISE_INLINE FORCE_FINLINE
+#endif
+
+[[nodiscard]] FORCE_FINLINE bool useAVX2() {
+#ifdef __AVX2__
+   return true;
+#else
+   return CPU::features.avx2;
+#endif
+}
+
+// a lane shifted by 64 or more is zeroed, so that only one of both shifts is applied in each lane
+[[nodiscard]] SETWISE_TARGET SETWISE_INLINE __m256i shift4(const __m256i b, const __m256i up, const __m256i down) {
+   return _mm256_or_si256(_mm256_sllv_epi64(b, up), _mm256_srlv_epi64(b, down));
+}
+
+template<Piece pp> [[nodiscard]] SETWISE_TARGET SETWISE_INLINE __m256i rays4(const BitBoard pieces, const BitBoard occupancy) {
+   using D = Dir<pp>;
+   const __m256i wrap  = _mm256_setr_epi64x(static_cast<long long>(D::wrap[0]), static_cast<long long>(D::wrap[1]),
+                                            static_cast<long long>(D::wrap[2]), static_cast<long long>(D::wrap[3]));
+   const __m256i up1   = _mm256_setr_epi64x(D::shift[0], D::shift[1], 64, 64);
+   const __m256i down1 = _mm256_setr_epi64x(64, 64, D::shift[2], D::shift[3]);
+   const __m256i up2   = _mm256_slli_epi64(up1, 1);
+   const __m256i down2 = _mm256_slli_epi64(down1, 1);
+   const __m256i up4   = _mm256_slli_epi64(up1, 2);
+   const __m256i down4 = _mm256_slli_epi64(down1, 2);
+   __m256i gen = _mm256_set1_epi64x(static_cast<long long>(pieces));
+   __m256i pro = _mm256_and_si256(_mm256_set1_epi64x(static_cast<long long>(~occupancy)), wrap);
+   gen = _mm256_or_si256(gen, _mm256_and_si256(pro, shift4(gen, up1, down1)));
+   pro = _mm256_and_si256(pro, shift4(pro, up1, down1));
+   gen = _mm256_or_si256(gen, _mm256_and_si256(pro, shift4(gen, up2, down2)));
+   pro = _mm256_and_si256(pro, shift4(pro, up2, down2));
+   gen = _mm256_or_si256(gen, _mm256_and_si256(pro, shift4(gen, up4, down4)));
+   return _mm256_and_si256(shift4(gen, up1, down1), wrap);
+}
+
+[[nodiscard]] SETWISE_TARGET SETWISE_INLINE BitBoard orLanes(const __m256i v) {
+   const __m128i o = _mm_or_si128(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+   return static_cast<BitBoard>(_mm_cvtsi128_si64(_mm_or_si128(o, _mm_unpackhi_epi64(o, o))));
+}
+
+template<Piece pp> [[nodiscard]] SETWISE_TARGET SETWISE_INLINE BitBoard coverageAVX2(const BitBoard pieces, const BitBoard occupancy) {
+   return orLanes(rays4<pp>(pieces, occupancy));
+}
+
+template<Piece pp> [[nodiscard]] SETWISE_TARGET SETWISE_INLINE array1d<BitBoard,4> raysAVX2(const BitBoard pieces, const BitBoard occupancy) {
+   alignas(32) array1d<BitBoard,4> r;
+   _mm256_store_si256(reinterpret_cast<__m256i*>(r.data()), rays4<pp>(pieces, occupancy));
+   return r;
+}
+#endif // __AVX2__ || WITH_CPU_DISPATCH
+
+template<Piece pp> [[nodiscard]] FORCE_FINLINE BitBoard coverage(const BitBoard pieces, const BitBoard occupancy) {
+#ifdef WITH_SETWISE_AVX2
+   if (useAVX2()) return coverageAVX2<pp>(pieces, occupancy);
+#endif
+   const array1d<BitBoard,4> r = rays<pp>(pieces, occupancy);
+   return r[0] | r[1] | r[2] | r[3];
+}
+
+// rays of two pieces of the set in the same direction never overlap as long as pieces are in occupancy
+// (the nearest one blocks the other), so that this is the sum of per piece counts
+template<Piece pp> [[nodiscard]] FORCE_FINLINE uint16_t mobility(const BitBoard pieces, const BitBoard occupancy, const BitBoard target) {
+   assert((pieces & occupancy) == pieces);
+#ifdef WITH_SETWISE_AVX2
+   const array1d<BitBoard,4> r = useAVX2() ? raysAVX2<pp>(pieces, occupancy) : rays<pp>(pieces, occupancy);
+#else
+   const array1d<BitBoard,4> r = rays<pp>(pieces, occupancy);
+#endif
+   return static_cast<uint16_t>(BB::countBit(r[0] & target) + BB::countBit(r[1] & target) + BB::countBit(r[2] & target) + BB::countBit(r[3] & target));
+}
+
+} // namespace SetWise
+
+// Set-wise user API, union of the attacks of all pieces in the set (for queens, bishop and rook fills are both done)
+template < Piece > [[nodiscard]] FORCE_FINLINE BitBoard coverageSet      (const BitBoard       , const BitBoard          ) { assert(false); return emptyBitBoard; }
+template <       > [[nodiscard]] FORCE_FINLINE BitBoard coverageSet<P_wb>(const BitBoard pieces, const BitBoard occupancy) { return SetWise::coverage<P_wb>(pieces, occupancy); }
+template <       > [[nodiscard]] FORCE_FINLINE BitBoard coverageSet<P_wr>(const BitBoard pieces, const BitBoard occupancy) { return SetWise::coverage<P_wr>(pieces, occupancy); }
+template <       > [[nodiscard]] FORCE_FINLINE BitBoard coverageSet<P_wq>(const BitBoard pieces, const BitBoard occupancy) { return SetWise::coverage<P_wb>(pieces, occupancy) | SetWise::coverage<P_wr>(pieces, occupancy); }
+
+// Sum over pieces of the set of countBit(coverage & target), pieces must be in occupancy
+template < Piece > [[nodiscard]] FORCE_FINLINE uint16_t mobilitySet      (const BitBoard       , const BitBoard          , const BitBoard       ) { assert(false); return 0; }
+template <       > [[nodiscard]] FORCE_FINLINE uint16_t mobilitySet<P_wb>(const BitBoard pieces, const BitBoard occupancy, const BitBoard target) { return SetWise::mobility<P_wb>(pieces, occupancy, target); }
+template <       > [[nodiscard]] FORCE_FINLINE uint16_t mobilitySet<P_wr>(const BitBoard pieces, const BitBoard occupancy, const BitBoard target) { return SetWise::mobility<P_wr>(pieces, occupancy, target); }
+template <       > [[nodiscard]] FORCE_FINLINE uint16_t mobilitySet<P_wq>(const BitBoard pieces, const BitBoard occupancy, const BitBoard target) { return static_cast<uint16_t>(SetWise::mobility<P_wb>(pieces, occupancy, target) + SetWise::mobility<P_wr>(pieces, occupancy, target)); }
+
 // Convenient function to check is a square is under attack or not
 [[nodiscard]] bool isAttackedBB(const Position &p, const Square s, const Color c);
+// Same with a given occupancy (for instance without the moving king)
+[[nodiscard]] bool isAttackedBB(const Position &p, const Square s, const Color c, const BitBoard occupancy);
+
+// Squares attacked by the opponent of Color c with a given occupancy (sliders are done set-wise)
+[[nodiscard]] BitBoard attackedSet(const Position &p, const Color c, const BitBoard occupancy);
 
 // Convenient function to return the bitboard of all attacker of a specific square
 [[nodiscard]] BitBoard allAttackedBB(const Position &p, const Square s, const Color c);
 [[nodiscard]] BitBoard allAttackedBB(const Position &p, const Square s);
 
+/*!
+ * Attack map of a position : squares attacked by each side and piece type, and pieces giving check.
+ * It is computed once per node (see EvalData::attacks, filled by evaluation) and shared
+ * with search (threats, SEE) instead of looking slider attacks up again square by square.
+ * Pawns are done set-wise, onPiece(c, pp, k, target) is called for every other piece.
+ */
+struct AttackMap {
+   array2d<BitBoard,2,6> byPiece;  // squares attacked by each piece type of Color
+   array2d<BitBoard,2,6> checkers; // pieces of Color (by type) attacking the opponent king
+   colored<BitBoard>     all;      // squares attacked by Color
+   colored<BitBoard>     twice;    // squares attacked at least twice by Color
+   bool                  done = false; // other members are only valid once computed
+
+   template<typename F> void compute(const Position &p, F && onPiece);
+   void compute(const Position &p) { compute(p, [](const Color, const Piece, const Square, const BitBoard) {}); }
+
+   // a piece leaving a square can only uncover (x-ray) an attack of a slider already attacking this square
+   [[nodiscard]] FORCE_FINLINE BitBoard sliders(const Color c) const { return byPiece[c][P_wb - 1] | byPiece[c][P_wr - 1] | byPiece[c][P_wq - 1]; }
+};
+
+template<typename F> void AttackMap::compute(const Position &p, F && onPiece) {
+   const BitBoard occupancy = p.occupancy();
+   for (Color c = Co_White; c <= Co_Black; ++c) {
+      const BitBoard pawns     = p.pieces_const<P_wp>(c);
+      const BitBoard enemyKing = p.pieces_const<P_wk>(~c);
+      byPiece[c]  = {{emptyBitBoard}};
+      checkers[c] = {{emptyBitBoard}};
+      if (c == Co_White) {
+         byPiece[c][P_wp - 1]  = pawnAttacks<Co_White>(pawns);
+         twice[c]              = pawnDoubleAttacks<Co_White>(pawns);
+         checkers[c][P_wp - 1] = pawnAttacks<Co_Black>(enemyKing) & pawns;
+      }
+      else {
+         byPiece[c][P_wp - 1]  = pawnAttacks<Co_Black>(pawns);
+         twice[c]              = pawnDoubleAttacks<Co_Black>(pawns);
+         checkers[c][P_wp - 1] = pawnAttacks<Co_White>(enemyKing) & pawns;
+      }
+      all[c] = byPiece[c][P_wp - 1];
+      for (Piece pp = P_wn; pp <= P_wk; ++pp) {
+         BB::applyOn(p.pieces_const(c, pp), [&](const Square & k) {
+            const BitBoard target = pfCoverage[pp - 1](k, occupancy, c);
+            byPiece[c][pp - 1] |= target;
+            twice[c] |= all[c] & target;
+            all[c] |= target;
+            if (target & enemyKing) checkers[c][pp - 1] |= SquareToBitboard(k);
+            onPiece(c, pp, k, target);
+         });
+      }
+   }
+   done = true;
+}
+
 } // namespace BBTools
 
 // Those are wrapper functions around isAttackedBB
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "cpu.hpp"
 #include "definition.hpp"
 
 /*!
@@ -55,7 +56,20 @@ FORCE_FINLINE int bitScanForward(int64_t bb) {
 #define swapbits32(x) (_byteswap_ulong(x))
 #endif // _WIN64
 #else  // _WIN32 (thus linux)
+#if defined(WITH_CPU_DISPATCH) && !defined(__POPCNT__)
+// generic build, popcnt instruction used only if available
+FORCE_FINLINE int popcount(uint64_t b) {
+   if (CPU::features.popcnt) {
+      uint64_t r;
+      __asm__("popcntq %1, %0" : "=r"(r) : "r"(b));
+      return static_cast<int>(r);
+   }
+   return __builtin_popcountll(b);
+}
+#define POPCOUNT(x)   popcount(x)
+#else
 #define POPCOUNT(x)   static_cast<int>(__builtin_popcountll(x))
+#endif
 FORCE_FINLINE int bitScanForward(BitBoard bb) {
    assert(isNotEmpty(bb));
    return __builtin_ctzll(bb);
@@ -25,6 +25,12 @@ void selfPlay(DepthType depth, uint64_t & nbPos);
 // see cli_SEETest.cpp
 bool TestSEE();
 
+// see cli_attackSpeed.cpp
+bool attackSpeed(DepthType depth);
+
+// see cli_pickSpeed.cpp
+bool pickSpeed(DepthType depth);
+
 void analyze(const Position& p, DepthType depth, bool openBenchOutput = false) {
    static double  benchms    = 0;
    static Counter benchNodes = 0;
@@ -54,8 +60,7 @@ void analyze(const Position& p, DepthType depth, bool openBenchOutput = false) {
    if (openBenchOutput) {
       Logging::LogIt(Logging::logInfo) << "Next two lines are for OpenBench";
       const TimeType ms = getTimeDiff(ThreadPool::instance().main().startTime);
-      const Counter nodeCount =
-          ThreadPool::instance().main().stats.counters[Stats::sid_nodes] + ThreadPool::instance().main().stats.counters[Stats::sid_qnodes];
+      const Counter nodeCount = ThreadPool::instance().main().stats.nodes();
       benchNodes += nodeCount;
       benchms += static_cast<decltype(benchms)>(ms) / 1000.;
       DynamicConfig::minOutputLevel = oldOutLvl;
@@ -319,6 +324,18 @@ bool cliManagement(const std::string & firstArg, int argc, char** argv) {
       return benchBig(d);
    }
 
+   if (firstArg == "-attackSpeed") {
+      DepthType d = 2;
+      if (argc > 2) d = clampDepth(atoi(args[2]));
+      return attackSpeed(d);
+   }
+
+   if (firstArg == "-pickSpeed") {
+      DepthType d = 2;
+      if (argc > 2) d = clampDepth(atoi(args[2]));
+      return pickSpeed(d);
+   }
+
    if (firstArg == "-evalSpeed") {
       DynamicConfig::disableTT = true;
       std::string filename     = "Book_and_Test/TestSuite/evalSpeed.epd";
@@ -366,6 +383,53 @@ bool cliManagement(const std::string & firstArg, int argc, char** argv) {
       return true;
    }
 
+#ifdef WITH_NNUE
+   // compare integer inner layers inference to the float one
+   if (firstArg == "-nnueAccuracy") {
+      if constexpr (!nnue::Quantization<NNUEWrapper::quantization>::innerInt) {
+         Logging::LogIt(Logging::logWarn) << "Minic was not compiled with WITH_NNUE_INT8_INNER, nothing to compare";
+         return true;
+      }
+      if (!DynamicConfig::useNNUE) {
+         Logging::LogIt(Logging::logWarn) << "No NNUE net loaded";
+         return true;
+      }
+      std::string filename = "Book_and_Test/TestSuite/evalSpeed.epd";
+      if (argc > 2) filename = args[2];
+      std::vector<std::string> positions;
+      DISCARD readEPDFile(filename, positions);
+      // evaluators are computed once, only propagation is compared
+      std::vector<NNUEEvaluator> evaluators(positions.size());
+      std::vector<std::pair<Color, int>> inputs;
+      for (size_t k = 0; k < positions.size(); ++k) {
+         RootPosition p(positions[k], false);
+         p.associateEvaluator(evaluators[k]);
+         p.resetNNUEEvaluator(evaluators[k]);
+         inputs.emplace_back(p.c, std::min(32, static_cast<int>(BB::countBit(p.occupancy()))));
+      }
+      Logging::LogIt(Logging::logInfo) << "Data size : " << evaluators.size();
+      std::vector<float> vFloat(evaluators.size());
+      std::vector<float> vInt(evaluators.size());
+      auto startTime = Clock::now();
+      for (size_t k = 0; k < evaluators.size(); ++k) vFloat[k] = evaluators[k].propagateFloat(inputs[k].first, inputs[k].second);
+      const auto msFloat = getTimeDiff(startTime);
+      startTime = Clock::now();
+      for (size_t k = 0; k < evaluators.size(); ++k) vInt[k] = evaluators[k].propagate(inputs[k].first, inputs[k].second);
+      const auto msInt = getTimeDiff(startTime);
+      double sumDiff = 0;
+      double maxDiff = 0;
+      for (size_t k = 0; k < evaluators.size(); ++k) {
+         const double diff = std::fabs(vFloat[k] - vInt[k]);
+         sumDiff += diff;
+         maxDiff = std::max(maxDiff, diff);
+      }
+      Logging::LogIt(Logging::logInfo) << "Mean absolute difference : " << sumDiff / static_cast<double>(asLeastOne(evaluators.size()));
+      Logging::LogIt(Logging::logInfo) << "Max absolute difference  : " << maxDiff;
+      Logging::LogIt(Logging::logInfo) << "Time float " << msFloat << "ms, time int " << msInt << "ms";
+      return true;
+   }
+#endif
+
    if (firstArg == "-timeTest") {
       TimeMan::TCType tcType      = TimeMan::TC_suddendeath;
       TimeType        initialTime = 50000;
@@ -539,7 +603,9 @@ bool cliManagement(const std::string & firstArg, int argc, char** argv) {
       perft(p, d, acc);
       auto elapsed = getTimeDiff(start);
       Logging::LogIt(Logging::logInfo) << "Perft done in " << elapsed << "ms";
-      acc.Display();
+      if (DynamicConfig::perftDetails) acc.Display();
+      else
+         Logging::LogIt(Logging::logInfo) << "validNodes    " << acc.validNodes;
       Logging::LogIt(Logging::logInfo) << "Speed " << static_cast<int>(acc.validNodes / elapsed) << "KNPS";
       return true;
    }
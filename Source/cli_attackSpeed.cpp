@@ -0,0 +1,127 @@
+#include "definition.hpp"
+
+#include "attack.hpp"
+#include "logging.hpp"
+#include "moveGen.hpp"
+#include "position.hpp"
+#include "positionTools.hpp"
+
+namespace {
+
+// what slider attacks need from a position
+struct AttackSample {
+   colored<BitBoard> diagonal;   // bishops and queens
+   colored<BitBoard> orthogonal; // rooks and queens
+   colored<BitBoard> own;
+   BitBoard          occupancy;
+};
+
+AttackSample makeSample(const Position& p) {
+   AttackSample s;
+   for (Color c = Co_White; c <= Co_Black; ++c) {
+      s.diagonal[c]   = p.pieces_const<P_wb>(c) | p.pieces_const<P_wq>(c);
+      s.orthogonal[c] = p.pieces_const<P_wr>(c) | p.pieces_const<P_wq>(c);
+      s.own[c]        = p.allPieces[c];
+   }
+   s.occupancy = p.occupancy();
+   return s;
+}
+
+// positions and all their children up to depth
+void collect(const Position& p, const DepthType depth, std::vector<AttackSample>& samples) {
+   samples.push_back(makeSample(p));
+   if (depth == 0) return;
+   MoveList moves;
+   MoveGen::generate<MoveGen::GP_all>(p, moves);
+   for (const auto& m : moves) {
+      Position p2 = p;
+      if (const Position::MoveInfo moveInfo(p2, m); !applyMove(p2, moveInfo, true)) continue;
+      collect(p2, depth - 1, samples);
+   }
+}
+
+// square-wise reference, using the configured backend (magic or HQ)
+[[nodiscard]] BitBoard coverageBySquare(const AttackSample& s, const Color c) {
+   BitBoard att = emptyBitBoard;
+   BB::applyOn(s.diagonal[c], [&](const Square& k) { att |= BBTools::coverage<P_wb>(k, s.occupancy, c); });
+   BB::applyOn(s.orthogonal[c], [&](const Square& k) { att |= BBTools::coverage<P_wr>(k, s.occupancy, c); });
+   return att;
+}
+
+[[nodiscard]] BitBoard mobilityBySquare(const AttackSample& s, const Color c) {
+   BitBoard mob = 0;
+   BB::applyOn(s.diagonal[c], [&](const Square& k) { mob += BB::countBit(BBTools::coverage<P_wb>(k, s.occupancy, c) & ~s.own[c]); });
+   BB::applyOn(s.orthogonal[c], [&](const Square& k) { mob += BB::countBit(BBTools::coverage<P_wr>(k, s.occupancy, c) & ~s.own[c]); });
+   return mob;
+}
+
+[[nodiscard]] BitBoard coverageSetWise(const AttackSample& s, const Color c) {
+   return BBTools::coverageSet<P_wb>(s.diagonal[c], s.occupancy) | BBTools::coverageSet<P_wr>(s.orthogonal[c], s.occupancy);
+}
+
+[[nodiscard]] BitBoard mobilitySetWise(const AttackSample& s, const Color c) {
+   return BBTools::mobilitySet<P_wb>(s.diagonal[c], s.occupancy, ~s.own[c]) + BBTools::mobilitySet<P_wr>(s.orthogonal[c], s.occupancy, ~s.own[c]);
+}
+
+// portable Kogge-Stone, whatever the simd support
+[[nodiscard]] BitBoard coverageSetWiseScalar(const AttackSample& s, const Color c) {
+   const auto d = BBTools::SetWise::rays<P_wb>(s.diagonal[c], s.occupancy);
+   const auto o = BBTools::SetWise::rays<P_wr>(s.orthogonal[c], s.occupancy);
+   return d[0] | d[1] | d[2] | d[3] | o[0] | o[1] | o[2] | o[3];
+}
+
+} // namespace
+
+// set-wise slider attacks (Kogge-Stone) against square-wise ones : same results and speed
+bool attackSpeed(const DepthType depth) {
+   std::vector<AttackSample> samples;
+   for (const auto& fen : {startPosition, fine70, shirov, std::string("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq -")}) {
+      RootPosition p;
+      readFEN(fen, p, true);
+      collect(p, depth, samples);
+   }
+   Logging::LogIt(Logging::logInfo) << "Attack speed with " << samples.size() << " positions";
+
+   for (const auto& s : samples) {
+      for (Color c = Co_White; c <= Co_Black; ++c) {
+         if (coverageSetWise(s, c) != coverageBySquare(s, c) || coverageSetWiseScalar(s, c) != coverageBySquare(s, c) ||
+             mobilitySetWise(s, c) != mobilityBySquare(s, c)) {
+            Logging::LogIt(Logging::logError) << "Set-wise attacks differ from square-wise ones";
+            Logging::LogIt(Logging::logError) << ToString(s.occupancy);
+            return false;
+         }
+      }
+   }
+
+   // loops over all samples until at least minUs
+   const auto timeIt = [&](const std::string& name, BitBoard (*f)(const AttackSample&, const Color)) {
+      const int64_t minUs = 500000;
+      BitBoard sink  = emptyBitBoard;
+      Counter  loops = 0;
+      int64_t  us    = 0;
+      const auto startTime = Clock::now();
+      do {
+         for (const auto& s : samples) sink += f(s, Co_White) + f(s, Co_Black);
+         ++loops;
+         us = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - startTime).count();
+      } while (us < minUs);
+      Logging::LogIt(Logging::logInfo) << name << " : " << static_cast<double>(samples.size()) * static_cast<double>(loops) * 2 / static_cast<double>(std::max(us, int64_t(1)))
+                                       << " Mset/s (" << sink << ")";
+   };
+#ifdef WITH_MAGIC
+   const std::string backend = "magic";
+#else
+   const std::string backend = "HQ";
+#endif
+#ifdef WITH_SETWISE_AVX2
+   const std::string setBackend = BBTools::SetWise::useAVX2() ? "Kogge-Stone avx2" : "Kogge-Stone";
+#else
+   const std::string setBackend = "Kogge-Stone";
+#endif
+   timeIt("coverage, square-wise " + backend, &coverageBySquare);
+   timeIt("coverage, set-wise " + setBackend, &coverageSetWise);
+   timeIt("coverage, set-wise Kogge-Stone scalar", &coverageSetWiseScalar);
+   timeIt("mobility, square-wise " + backend, &mobilityBySquare);
+   timeIt("mobility, set-wise " + setBackend, &mobilitySetWise);
+   return true;
+}
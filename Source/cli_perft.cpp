@@ -1,9 +1,12 @@
 #include "definition.hpp"
 
+#include "dynamicConfig.hpp"
+#include "hash.hpp"
 #include "logging.hpp"
 #include "moveGen.hpp"
 #include "position.hpp"
 #include "positionTools.hpp"
+#include "tools.hpp"
 
 void PerftAccumulator::Display() const{
    Logging::LogIt(Logging::logInfo) << "pseudoNodes   " << pseudoNodes;
@@ -16,7 +19,10 @@ void PerftAccumulator::Display() const{
    Logging::LogIt(Logging::logInfo) << "checkMateNode " << checkMateNode;
 }
 
-Counter perft(const Position& p, DepthType depth, PerftAccumulator& acc) {
+namespace {
+
+// detailed perft (single threaded, no hash), fills a PerftAccumulator
+Counter perftDetailed(const Position& p, DepthType depth, PerftAccumulator& acc) {
    if (depth == 0) return 0;
    MoveList         moves;
    PerftAccumulator accLoc;
@@ -45,12 +51,149 @@ Counter perft(const Position& p, DepthType depth, PerftAccumulator& acc) {
       if (isCapture(t)) ++accLoc.captureNodes;
       if (isCastling(t)) ++accLoc.castling;
       if (isPromotion(t)) ++accLoc.promotion;
-      perft(p2, depth - 1, acc);
+      perftDetailed(p2, depth - 1, acc);
    }
    if (depth == 1) acc += accLoc;
    return acc.validNodes;
 }
 
+// Lock-free perft hash shared by all threads.
+// Key is stored xored with data so that an entry torn by concurrent writes never validates.
+struct PerftHash {
+   struct Entry {
+      std::atomic<uint64_t> key {0};  // hash ^ data
+      std::atomic<uint64_t> data {0}; // nodes << 8 | depth
+   };
+
+   // same unit as the TT size (SIZE_MULTIPLIER), at least one entry
+   void init(const size_t sizeMb) {
+      const size_t n = std::max(size_t(1), static_cast<size_t>(powerFloor((SIZE_MULTIPLIER * sizeMb) / sizeof(Entry))));
+      table.reset(new Entry[n]);
+      mask = n - 1;
+      Logging::LogIt(Logging::logInfo) << "Perft hash size " << n * sizeof(Entry) / 1024 << "Kb (" << n << " entries)";
+   }
+
+   void release() {
+      table.reset();
+      mask = 0;
+   }
+
+   [[nodiscard]] size_t index(const Hash h, const DepthType depth) const {
+      // same position at different depths shall not evict each other
+      return (h ^ (static_cast<uint64_t>(depth) * 0x9E3779B97F4A7C15ull)) & mask;
+   }
+
+   [[nodiscard]] bool probe(const Hash h, const DepthType depth, Counter& nodes) const {
+      const Entry&   e    = table[index(h, depth)];
+      const uint64_t data = e.data.load(std::memory_order_relaxed);
+      if ((e.key.load(std::memory_order_relaxed) ^ data) != h || static_cast<DepthType>(data & 0xFF) != depth) return false;
+      nodes = data >> 8;
+      return true;
+   }
+
+   void store(const Hash h, const DepthType depth, const Counter nodes) {
+      Entry&         e    = table[index(h, depth)];
+      const uint64_t data = (nodes << 8) | static_cast<uint8_t>(depth);
+      e.key.store(h ^ data, std::memory_order_relaxed);
+      e.data.store(data, std::memory_order_relaxed);
+   }
+
+   std::unique_ptr<Entry[]> table;
+   size_t                   mask {0};
+};
+
+PerftHash perftHash;
+
+// legal moves count (only king-less variants still need applyMove validation)
+[[nodiscard]] Counter bulkCount(const Position& p) {
+   const MoveGen::LegalMasks masks(p);
+   MoveList moves;
+   MoveGen::generateLegal<MoveGen::GP_all>(p, moves, masks);
+   if (masks.valid) return moves.size();
+   Counter n = 0;
+#ifdef WITH_MAKE_UNMAKE
+   Position p2 = p;
+   for (const auto& m : moves) {
+      const Position::MoveInfo moveInfo(p2, m);
+      const ScopedMove         made(p2, moveInfo);
+      if (made.valid) ++n;
+   }
+#else
+   for (const auto& m : moves) {
+      Position p2 = p;
+      if (const Position::MoveInfo moveInfo(p2, m); applyMove(p2, moveInfo, true)) ++n;
+   }
+#endif
+   return n;
+}
+
+// hashed perft, bulk counting at depth 1
+Counter perftHashed(const Position& p, DepthType depth, const Hash salt) {
+   if (depth == 1) return bulkCount(p);
+   const Hash h     = computeHash(p) ^ salt;
+   Counter    nodes = 0;
+   if (perftHash.probe(h, depth, nodes)) return nodes;
+   const MoveGen::LegalMasks masks(p);
+   MoveList moves;
+   MoveGen::generateLegal<MoveGen::GP_all>(p, moves, masks);
+#ifdef WITH_MAKE_UNMAKE
+   Position p2 = p;
+   for (const auto& m : moves) {
+      const Position::MoveInfo moveInfo(p2, m);
+      const ScopedMove         made(p2, moveInfo, masks.valid);
+      if (made.valid) nodes += perftHashed(p2, depth - 1, salt);
+   }
+#else
+   for (const auto& m : moves) {
+      Position p2 = p;
+      if (const Position::MoveInfo moveInfo(p2, m); !applyMove(p2, moveInfo, true, masks.valid)) continue;
+      nodes += perftHashed(p2, depth - 1, salt);
+   }
+#endif
+   perftHash.store(h, depth, nodes);
+   return nodes;
+}
+
+// multi-threaded perft, root moves are split across threads
+Counter perftThreaded(const Position& p, DepthType depth) {
+   if (depth == 0) return 0;
+   if (depth == 1) return bulkCount(p);
+   // castling rook files are root information not included in the position hash
+   Hash salt = nullHash;
+   for (const auto& rooks : p.rootInfo().rooksInit)
+      for (const Square r : rooks) salt = salt * NbSquare + static_cast<Hash>(r + 1);
+   salt *= 0x9E3779B97F4A7C15ull;
+
+   const MoveGen::LegalMasks masks(p);
+   MoveList moves;
+   MoveGen::generateLegal<MoveGen::GP_all>(p, moves, masks);
+   if (moves.empty()) return 0;
+
+   // only alive during perft, on top of the TT
+   perftHash.init(DynamicConfig::ttSizeMb);
+   std::atomic<Counter> nodes {0};
+   auto worker = [&](const size_t begin, const size_t end) {
+      Counter n = 0;
+      for (size_t k = begin; k < end; ++k) {
+         Position p2 = p;
+         if (const Position::MoveInfo moveInfo(p2, moves[k]); !applyMove(p2, moveInfo, true, masks.valid)) continue;
+         n += perftHashed(p2, depth - 1, salt);
+      }
+      nodes += n;
+   };
+   threadedWork(worker, std::clamp(static_cast<size_t>(DynamicConfig::threads), size_t(1), moves.size()), moves.size());
+   perftHash.release();
+   return nodes;
+}
+
+} // namespace
+
+Counter perft(const Position& p, DepthType depth, PerftAccumulator& acc) {
+   if (DynamicConfig::perftDetails) return perftDetailed(p, depth, acc);
+   acc.validNodes = perftThreaded(p, depth);
+   return acc.validNodes;
+}
+
 [[nodiscard]] bool perft_test(const std::string& fen, DepthType d, uint64_t expected) {
    RootPosition p;
 #ifdef WITH_NNUE
@@ -61,10 +204,12 @@ Counter perft(const Position& p, DepthType depth, PerftAccumulator& acc) {
    Logging::LogIt(Logging::logInfo) << ToString(p);
    PerftAccumulator acc;
    const uint64_t n = perft(p, d, acc);
-   acc.Display();
+   if (DynamicConfig::perftDetails) acc.Display();
+   else
+      Logging::LogIt(Logging::logInfo) << "validNodes    " << n;
    if (n != expected){
       Logging::LogIt(Logging::logError) << "Error !! " << fen << " " << expected;
       return false;
    }
    return true;
-}
\ No newline at end of file
+}
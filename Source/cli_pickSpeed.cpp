@@ -0,0 +1,96 @@
+#include "definition.hpp"
+
+#include "logging.hpp"
+#include "moveGen.hpp"
+#include "moveSort.hpp"
+#include "position.hpp"
+#include "positionTools.hpp"
+
+namespace {
+
+// move lists of positions and all their children up to depth, with pseudo random scores (and some ties)
+void collect(const Position& p, const DepthType depth, std::vector<MoveList>& lists) {
+   MoveList moves;
+   MoveGen::generate<MoveGen::GP_all>(p, moves);
+   MoveList scored;
+   for (const auto& m : moves) scored.push_back(ToMove(Move2From(m), Move2To(m), Move2Type(m), randomInt<ScoreType, 42>(-250, 250)));
+   lists.push_back(scored);
+   if (depth == 0) return;
+   for (const auto& m : moves) {
+      Position p2 = p;
+      if (const Position::MoveInfo moveInfo(p2, m); !applyMove(p2, moveInfo, true)) continue;
+      collect(p2, depth - 1, lists);
+   }
+}
+
+// previous linear pick, used as reference
+[[nodiscard]] const Move* pickNextLinear(MoveList& moves, size_t& begin) {
+   if (begin >= moves.size()) return nullptr;
+   const auto it = std::min_element(moves.begin() + begin, moves.end(), MoveSortOperator());
+   std::iter_swap(moves.begin() + begin, it);
+   return &*(moves.begin() + (begin++));
+}
+
+[[nodiscard]] const Move* pickNextScan(MoveList& moves, size_t& begin) { return MoveSorter::pickNext(moves, begin); }
+
+} // namespace
+
+// MoveSorter::pickNext max scan against a linear min_element pick : same order and speed for the first k moves
+bool pickSpeed(const DepthType depth) {
+#ifndef USE_PARTIAL_SORT
+   Logging::LogIt(Logging::logWarn) << "pickNext does not select moves without USE_PARTIAL_SORT";
+   return false;
+#else
+   std::vector<MoveList> lists;
+   for (const auto& fen : {startPosition, fine70, shirov, std::string("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq -")}) {
+      RootPosition p;
+      readFEN(fen, p, true);
+      collect(p, depth, lists);
+   }
+   size_t nbMoves = 0;
+   for (const auto& moves : lists) nbMoves += moves.size();
+   Logging::LogIt(Logging::logInfo) << "Pick speed with " << lists.size() << " move lists (" << static_cast<double>(nbMoves) / std::max(size_t(1), lists.size()) << " moves on average)";
+
+   for (const auto& moves : lists) {
+      MoveList l1 = moves;
+      MoveList l2 = moves;
+      size_t   b1 = 0;
+      size_t   b2 = 0;
+      while (const Move* m1 = pickNextScan(l1, b1)) {
+         const Move* m2 = pickNextLinear(l2, b2);
+         if (!m2 || *m1 != *m2) {
+            Logging::LogIt(Logging::logError) << "Max scan pick differs from linear pick";
+            return false;
+         }
+      }
+   }
+
+   // picking reorders the lists but keeps the same moves, so they are not restored between runs
+   const auto timeIt = [&](const std::string& name, const Move* (*pick)(MoveList&, size_t&), const size_t k) {
+      const int64_t minUs = 500000;
+      uint64_t sink  = 0;
+      Counter  picks = 0;
+      int64_t  us    = 0;
+      const auto startTime = Clock::now();
+      do {
+         for (auto& moves : lists) {
+            size_t begin = 0;
+            for (size_t n = 0; n < k; ++n) {
+               const Move* m = pick(moves, begin);
+               if (!m) break;
+               sink += *m;
+               ++picks;
+            }
+         }
+         us = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - startTime).count();
+      } while (us < minUs);
+      Logging::LogIt(Logging::logInfo) << name << " k=" << (k == MAX_MOVE ? std::string("all") : std::to_string(k)) << " : "
+                                       << 1000. * static_cast<double>(us) / static_cast<double>(std::max(picks, Counter(1))) << " ns/pick (" << sink << ")";
+   };
+   for (const size_t k : {size_t(1), size_t(3), size_t(8), size_t(MAX_MOVE)}) {
+      timeIt("linear  ", &pickNextLinear, k);
+      timeIt("max scan", &pickNextScan, k);
+   }
+   return true;
+#endif
+}
@@ -25,12 +25,23 @@ const std::string MinicVersion = "3.35";
 #endif
 //#define REPRODUCTIBLE_RESULTS           // clear state table betwwen all new search (not only all new games)
 #define WITH_NNUE_CLIPPED_RELU            // use clipped relu instead of relu for NNUE
+//#define WITH_NNUE_INT8_INNER            // use integer inference (int8 weights, int32 accumulation) for NNUE inner layers (needs clipped relu)
 #ifndef __ANDROID__
 #define USE_SIMD_INTRIN                   // on simd architectures, use a hand written dot product
+#define USE_AVX512_SIMD                   // when built for AVX-512, use 512 bits kernels (dot product and accumulator update)
+#endif
+// WITH_CPU_DISPATCH is given by the build (CPUDISPATCH=1 Tools/build/build.sh), a generic x86-64 Linux binary
+// then selects simd kernels, pext and popcount at startup (see cpu.hpp)
+#if defined(WITH_CPU_DISPATCH) && !(defined(__GNUC__) && defined(__x86_64__) && defined(__linux__))
+#undef WITH_CPU_DISPATCH
 #endif
 
 // *** Optim (?)
 #define USE_PARTIAL_SORT        // do not sort every move in move list
+//#define USE_STAGED_MOVEGEN    // pvs generates captures, refutations and then quiets only when needed (see MovePicker), changes move ordering
+#define USE_LEGAL_MOVEGEN       // search checks legality with pin and check masks before copy/apply (see MoveGen::LegalMasks)
+#define WITH_MAKE_UNMAKE        // perft makes/unmakes moves on a per node scratch position instead of copy/make (see ScopedMove)
+//#define WITH_MAKE_UNMAKE_SEARCH // same for pvs and qsearch (no measurable search gain yet)
 //#define WITH_EVALSCORE_AS_INT // in fact just as slow as my basic impl ...
 
 // *** Add-ons
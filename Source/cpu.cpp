@@ -0,0 +1,96 @@
+#include "cpu.hpp"
+
+#include "logging.hpp"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define WITH_CPUID
+#include <cpuid.h>
+#endif
+
+namespace {
+
+#ifdef WITH_CPUID
+// pext/pdep are microcoded (very slow) on AMD families before Zen3 (0x19)
+[[nodiscard]] bool slowPext() {
+   unsigned int eax = 0, ebx = 0, ecx = 0, edx = 0;
+   if (!__get_cpuid(0, &eax, &ebx, &ecx, &edx)) return false;
+   char vendor[13] = {0};
+   std::memcpy(vendor, &ebx, 4);
+   std::memcpy(vendor + 4, &edx, 4);
+   std::memcpy(vendor + 8, &ecx, 4);
+   if (std::string(vendor) != "AuthenticAMD" && std::string(vendor) != "HygonGenuine") return false;
+   if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx)) return false;
+   unsigned int family = (eax >> 8) & 0xF;
+   if (family == 0xF) family += (eax >> 20) & 0xFF;
+   return family < 0x19;
+}
+#endif
+
+} // namespace
+
+namespace CPU {
+
+Features features;
+
+void init() {
+#ifdef WITH_CPUID
+   __builtin_cpu_init();
+   features.popcnt   = __builtin_cpu_supports("popcnt");
+   features.sse41    = __builtin_cpu_supports("sse4.1");
+   features.avx2     = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+   features.bmi2     = __builtin_cpu_supports("bmi2");
+   features.fastPext = features.bmi2 && !slowPext();
+   features.avx512   = __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw");
+#endif
+
+#ifdef WITH_CPU_DISPATCH
+   features.simdWidth = features.sse41 ? 128 : 0;
+   if (features.avx2) features.simdWidth = 256;
+#ifdef USE_AVX512_SIMD
+   if (features.avx512) features.simdWidth = 512;
+#endif
+#else
+   // this binary was built for a given target, make sure this CPU can run it
+   // instead of crashing later on an illegal instruction
+   bool ok = true;
+#ifdef WITH_CPUID
+#ifdef __POPCNT__
+   ok &= features.popcnt;
+#endif
+#ifdef __SSE4_1__
+   ok &= features.sse41;
+#endif
+#ifdef __AVX2__
+   ok &= features.avx2;
+#endif
+#ifdef __BMI2__
+   ok &= features.bmi2;
+#endif
+#ifdef __AVX512BW__
+   ok &= features.avx512;
+#endif
+#endif
+   if (!ok) {
+      Logging::LogIt(Logging::logFatal) << "This binary was built for a more recent CPU (detected: " << ToString()
+                                        << "), please use a binary matching this hardware";
+   }
+#endif
+   Logging::LogIt(Logging::logInfo) << "CPU features: " << ToString();
+}
+
+std::string ToString() {
+   std::string ret;
+   if (features.popcnt) ret += "popcnt ";
+   if (features.sse41) ret += "sse4.1 ";
+   if (features.avx2) ret += "avx2 ";
+   if (features.bmi2) ret += features.fastPext ? "bmi2 " : "bmi2(slow pext) ";
+   if (features.avx512) ret += "avx512 ";
+#ifdef WITH_CPU_DISPATCH
+   ret += "(dispatch: simd " + std::to_string(features.simdWidth) + (features.fastPext ? ", pext" : ", no pext") + ")";
+#endif
+   if (ret.empty()) return "none";
+   if (ret.back() == ' ') ret.pop_back();
+   return ret;
+}
+
+} // namespace CPU
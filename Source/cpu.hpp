@@ -0,0 +1,31 @@
+#pragma once
+
+#include "definition.hpp"
+
+/*!
+ * Run-time CPU features detection
+ * With WITH_CPU_DISPATCH (generic x86-64 Linux build), those flags select
+ * the NNUE simd kernels, the pext magic index and hardware popcount.
+ * Otherwise they are only used to check that the binary can run on this CPU.
+ */
+namespace CPU {
+
+struct Features {
+   bool popcnt {false};
+   bool sse41 {false};
+   bool avx2 {false};     // with fma
+   bool bmi2 {false};
+   bool fastPext {false}; // bmi2 but not on AMD before Zen3 (microcoded pext)
+   bool avx512 {false};   // avx512f and avx512bw
+   int  simdWidth {0};    // widest simd kernels to be used (0, 128, 256 or 512)
+};
+
+extern Features features;
+
+// detect features, must be called before anything depending on them (magic tables, NNUE)
+void init();
+
+// human readable detected features
+[[nodiscard]] std::string ToString();
+
+} // namespace CPU
@@ -295,11 +295,64 @@ template<typename T>
 enum GamePhase { MG = 0, EG = 1, GP_MAX = 2 };
 ENABLE_INCR_OPERATORS_ON(GamePhase)
 
-template<typename T, int SIZE> struct OptList : public std::vector<T> {
-   OptList(): std::vector<T>() { std::vector<T>::reserve(SIZE); }
+// fixed capacity list with a std::vector like interface, stored inline (no heap allocation)
+// data are not initialized, copy only copies used elements
+template<typename T, size_t N> struct FixedList {
+   using value_type      = T;
+   using size_type       = size_t;
+   using reference       = T&;
+   using const_reference = const T&;
+   using iterator        = T*;
+   using const_iterator  = const T*;
+
+   FixedList() = default;
+   FixedList(const FixedList& other): _size(other._size) { std::copy(other.begin(), other.end(), begin()); }
+   FixedList& operator=(const FixedList& other) {
+      if (this != &other) {
+         _size = other._size;
+         std::copy(other.begin(), other.end(), begin());
+      }
+      return *this;
+   }
+
+   [[nodiscard]] FORCE_FINLINE iterator       begin()       { return _data; }
+   [[nodiscard]] FORCE_FINLINE iterator       end()         { return _data + _size; }
+   [[nodiscard]] FORCE_FINLINE const_iterator begin() const { return _data; }
+   [[nodiscard]] FORCE_FINLINE const_iterator end()   const { return _data + _size; }
+
+   [[nodiscard]] FORCE_FINLINE size_t size()  const { return _size; }
+   [[nodiscard]] FORCE_FINLINE bool   empty() const { return _size == 0; }
+   [[nodiscard]] static constexpr size_t capacity() { return N; }
+   [[nodiscard]] FORCE_FINLINE bool   full()  const { return _size == N; }
+
+   [[nodiscard]] FORCE_FINLINE T&       operator[](const size_t i)       { assert(i < _size); return _data[i]; }
+   [[nodiscard]] FORCE_FINLINE const T& operator[](const size_t i) const { assert(i < _size); return _data[i]; }
+   [[nodiscard]] FORCE_FINLINE T&       front()       { assert(_size); return _data[0]; }
+   [[nodiscard]] FORCE_FINLINE const T& front() const { assert(_size); return _data[0]; }
+   [[nodiscard]] FORCE_FINLINE T&       back()        { assert(_size); return _data[_size - 1]; }
+   [[nodiscard]] FORCE_FINLINE const T& back()  const { assert(_size); return _data[_size - 1]; }
+
+   FORCE_FINLINE void clear() { _size = 0; }
+   FORCE_FINLINE void push_back(const T& t) {
+      assert(_size < N);
+      _data[_size++] = t;
+   }
+   template<typename... Args> FORCE_FINLINE T& emplace_back(Args&&... args) {
+      assert(_size < N);
+      return _data[_size++] = T(std::forward<Args>(args)...);
+   }
+   FORCE_FINLINE void pop_back() {
+      assert(_size);
+      --_size;
+   }
+
+  private:
+   size_t _size {0};
+   T      _data[N];
 };
-using MoveList = OptList<Move, MAX_MOVE / 4>; ///@todo tune this ?
-using PVList = std::vector<Move>;
+
+using MoveList = FixedList<Move, MAX_MOVE>;
+using PVList = FixedList<Move, MAX_DEPTH + 1>;
 
 [[nodiscard]] constexpr MiniHash Hash64to32(Hash h) { return static_cast<MiniHash>((h >> 32) & 0xFFFFFFFF); }
 [[nodiscard]] constexpr MiniMove Move2MiniMove(Move m) { return static_cast<MiniMove>(m & 0xFFFF); } // skip score
@@ -12,6 +12,10 @@ unsigned int ttPawnSizeMb     = 1;  // here in Kb in fact (SIZE_MULTIPLIER), wil
 unsigned int ttSizeMb         = 128; // here in Mb, will be converted to real size next
 unsigned int ttPawnSizeMb     = 16;  // here in Mb, will be converted to real size next
 #endif
+bool         largePages       = true;
+std::string  numaPolicy       = "none";
+std::string  smpPolicy        = "static";
+std::string  threadBinding    = "none";
 bool         fullXboardOutput = false;
 bool         debugMode        = false;
 int          minOutputLevel   = Logging::logGUI;
@@ -57,6 +61,7 @@ unsigned int moveOverHead  = 50;
 bool         armageddon    = false;
 bool         antichess     = false;
 bool         withWDL       = false;
+bool         perftDetails  = false;
 
 std::string opponent          = "";
 int         ratingAdv         = 0;
@@ -12,6 +12,8 @@ extern bool         mateFinder;
 extern bool         disableTT;
 extern unsigned int ttSizeMb;
 extern unsigned int ttPawnSizeMb;
+extern bool         largePages;
+extern std::string  numaPolicy;
 extern bool         fullXboardOutput;
 extern bool         debugMode; // activate output in a file (see debugFile)
 extern int          minOutputLevel; // minimum output level
@@ -19,6 +21,8 @@ extern std::string  debugFile;
 extern unsigned int level;
 extern unsigned int randomOpen;
 extern unsigned int threads;
+extern std::string  smpPolicy; // helper threads depth scheduling : "static" (skip blocks) or "depthCount"
+extern std::string  threadBinding; // search threads pinning : "none", "cores" or "nodes"
 extern std::string  syzygyPath;
 extern bool         FRC;
 extern bool         DFRC;
@@ -46,6 +50,7 @@ extern bool         antichess; ///@todo not yet fully implemented due to king ca
 extern bool         withWDL;
 extern bool         bongCloud;
 extern bool         anarchy;
+extern bool         perftDetails; // perft : detailed (single threaded, not hashed) PerftAccumulator stats
 
 // handles chess variants
 inline bool isKingMandatory(){ return !antichess;}
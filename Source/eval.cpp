@@ -126,6 +126,8 @@ ScoreType evalAntiChess(const Position &p, EvalData &data, [[maybe_unused]] Sear
 
 #ifdef WITH_NNUE
 ScoreType NNUEEVal(const Position & p, EvalData &data, Searcher &context, EvalFeatures &features, bool secondTime = false){
+   // lazy accumulators are only computed here
+   computeNNUEEvaluator(p, &context.nnueFinny);
    START_TIMER
    if (DynamicConfig::armageddon) features.scalingFactor = 1.f;              ///@todo better
    // call the net
@@ -365,38 +367,31 @@ ScoreType eval(const Position &p, EvalData &data, Searcher &context, bool allowE
 
    // helpers that will be filled by evalPiece calls
    colored<ScoreType> kdanger = {0, 0};
-   colored<BitBoard>  att     = {emptyBitBoard, emptyBitBoard}; // bitboard of squares attacked by Color
-   colored<BitBoard>  att2    = {emptyBitBoard, emptyBitBoard}; // bitboard of squares attacked twice by Color
-   array2d<BitBoard,2,6>  attFromPiece = {{emptyBitBoard}};     // bitboard of squares attacked by specific piece of Color
-   array2d<BitBoard,2,6>  checkers     = {{emptyBitBoard}};     // bitboard of Color pieces squares attacking king
 
-   // PST, attack, danger
+   // PST, attack, danger (pawns are done later), the attack map is shared with search (see EvalData::attacks)
    const bool withForwadness = DynamicConfig::styleForwardness != 50;
    const array1d<ScoreType,2> staticColorSignHelper = { +1, -1};
-   for (Color c = Co_White ; c <= Co_Black ; ++c){
-      // will do pawns later
-      for (Piece pp = P_wn ; pp <= P_wk ; ++pp){
-         applyOn(p.pieces_const(c,pp), [&](const Square & k){
-            const Square kk = relative_square(~c,k);
-            features.scores[F_positional] += EvalConfig::PST[pp - 1][kk] * staticColorSignHelper[c];
-            if (withForwadness)
-               features.scores[F_positional] += EvalScore {ScoreType(((DynamicConfig::styleForwardness - 50) * SQRANK(kk)) / 8), 0} * staticColorSignHelper[c];
-            // aligned threats removing own piece (not pawn) in occupancy
-            const BitBoard shadowTarget = BBTools::pfCoverage[pp - 1](k, occupancy ^ nonPawnMat[c], c);
-            if (shadowTarget) {
-               kdanger[~c] += countBit(shadowTarget & kingZone[~c]) * EvalConfig::kingAttWeight[EvalConfig::katt_attack][pp - 1];
-               const BitBoard target = BBTools::pfCoverage[pp - 1](k, occupancy, c); // real targets
-               if (target) {
-                  attFromPiece[c][pp - 1] |= target;
-                  att2[c] |= att[c] & target;
-                  att[c] |= target;
-                  if (target & p.pieces_const<P_wk>(~c)) checkers[c][pp - 1] |= SquareToBitboard(k);
-                  kdanger[c] -= countBit(target & kingZone[c]) * EvalConfig::kingAttWeight[EvalConfig::katt_defence][pp - 1];
-               }
-            }
-         });
-      }
-   }
+   colored<BitBoard> piecesAtt = {emptyBitBoard, emptyBitBoard}; // bitboard of squares attacked by Color pieces (not pawns)
+   BBTools::AttackMap & attacks = data.attacks;
+   attacks.compute(p, [&](const Color c, const Piece pp, const Square k, const BitBoard target){
+      const Square kk = relative_square(~c,k);
+      features.scores[F_positional] += EvalConfig::PST[pp - 1][kk] * staticColorSignHelper[c];
+      if (withForwadness)
+         features.scores[F_positional] += EvalScore {ScoreType(((DynamicConfig::styleForwardness - 50) * SQRANK(kk)) / 8), 0} * staticColorSignHelper[c];
+      // aligned threats removing own piece (not pawn) in occupancy
+      const BitBoard shadowTarget = BBTools::pfCoverage[pp - 1](k, occupancy ^ nonPawnMat[c], c);
+      kdanger[~c] += countBit(shadowTarget & kingZone[~c]) * EvalConfig::kingAttWeight[EvalConfig::katt_attack][pp - 1];
+      kdanger[c] -= countBit(target & kingZone[c]) * EvalConfig::kingAttWeight[EvalConfig::katt_defence][pp - 1];
+      piecesAtt[c] |= target;
+   });
+   const colored<BitBoard>     & att      = attacks.all;      // bitboard of squares attacked by Color
+   const array2d<BitBoard,2,6> & checkers = attacks.checkers; // bitboard of Color pieces squares attacking king
+   // this evaluation does not count pawn threats in attFromPiece, nor a square attacked by two pawns only as attacked twice
+   array2d<BitBoard,2,6> attFromPiece = attacks.byPiece;     // bitboard of squares attacked by specific piece of Color
+   attFromPiece[Co_White][P_wp - 1] = attFromPiece[Co_Black][P_wp - 1] = emptyBitBoard;
+   const colored<BitBoard> att2 = { // bitboard of squares attacked twice by Color
+      attacks.twice[Co_White] & ~(BBTools::pawnDoubleAttacks<Co_White>(pawns[Co_White]) & ~piecesAtt[Co_White]),
+      attacks.twice[Co_Black] & ~(BBTools::pawnDoubleAttacks<Co_Black>(pawns[Co_Black]) & ~piecesAtt[Co_Black])};
 
    // random factor in opening if requiered
    if (p.halfmoves < 10 && DynamicConfig::randomOpen != 0){
@@ -557,12 +552,6 @@ ScoreType eval(const Position &p, EvalData &data, Searcher &context, bool allowE
    // update global things with freshy gotten pawn entry stuff
    kdanger[Co_White] += pe.danger[Co_White];
    kdanger[Co_Black] += pe.danger[Co_Black];
-   checkers[Co_White][0] = BBTools::pawnAttacks<Co_Black>(kings[Co_Black]) & pawns[Co_White];
-   checkers[Co_Black][0] = BBTools::pawnAttacks<Co_White>(kings[Co_White]) & pawns[Co_Black];
-   att2[Co_White] |= att[Co_White] & pe.pawnTargets[Co_White];
-   att2[Co_Black] |= att[Co_Black] & pe.pawnTargets[Co_Black];
-   att[Co_White] |= pe.pawnTargets[Co_White];
-   att[Co_Black] |= pe.pawnTargets[Co_Black];
 
    STOP_AND_SUM_TIMER(Eval3)
 
@@ -1,7 +1,9 @@
+#include "allocator.hpp"
 #include "attack.hpp"
 #include "bitboardTools.hpp"
 #include "cli.hpp"
 #include "com.hpp"
+#include "cpu.hpp"
 #include "definition.hpp"
 #include "distributed.h"
 #include "dynamicConfig.hpp"
@@ -37,7 +39,9 @@ inline void init(int argc, char** argv) {
    Logging::hellooo();
    Options::initOptions(argc, argv);
    Logging::init(); // after reading options
+   CPU::init();     // before magic and NNUE init (pext and simd kernels selection)
    Zobrist::initHash();
+   Allocator::init();
    TT::initTable();
    BBTools::initMask();
 #ifdef WITH_MAGIC
@@ -121,6 +125,8 @@ R"(
  * -perft_test_long : run a long perf test
  * -see_test : run a SEE test (most positions taken from Vajolet by Marco Belli a.k.a elcabesa)
  * -evalSpeed [filename] : run an evaluation performance test
+ * -attackSpeed [depth=2] : check and time set-wise slider attacks against square-wise ones (magic or HQ)
+ * -pickSpeed [depth=2] : check and time MoveSorter::pickNext max scan against a linear pick
  * -timeTest [initial=50000] [incr=0] [moveInTC=-1] [guiLag=0] : run a TC simulation
  * bench [depth=16] : used for OpenBench output
  Next commands needs at least a position
@@ -132,7 +138,7 @@ R"(
  * -evalHCE [pos] : run an evaluation (HCE)
  * -gen [pos] : generate available moves
  * -testmove [TODO] : test move application
- * -perft [pos] [depth=5] : run a perft on the given position for the given depth
+ * -perft [pos] [depth=5] : run a perft on the given position for the given depth (threaded and hashed, -perftDetails 1 for detailed stats)
  * -analyze [pos] [depth=15] : run an analysis for the given position to the given depth
  * -mateFinder [pos] [depth=10] : run an analysis in mate finder mode for the given position to the given depth
  * -probe [pos] : TB probe
@@ -73,7 +73,7 @@ void applyNull(Searcher&, Position& pN) {
    STOP_AND_SUM_TIMER(Apply)
 }
 
-bool applyMove(Position& p, const Position::MoveInfo & moveInfo, const bool noNNUEUpdate) {
+bool applyMove(Position& p, const Position::MoveInfo & moveInfo, const bool noNNUEUpdate, const bool noValidation) {
    assert(isValidMove(moveInfo.m));
    START_TIMER
 #ifdef DEBUG_MATERIAL
@@ -153,7 +153,7 @@ bool applyMove(Position& p, const Position::MoveInfo & moveInfo, const bool noNN
       case T_max: break;
    }
 
-   if (/*!noValidation &&*/ isPosInCheck(p)) {
+   if (!noValidation && isPosInCheck(p)) {
       STOP_AND_SUM_TIMER(Apply)
       return false; // this is the only legal move validation needed
    }
@@ -245,32 +245,92 @@ bool applyMove(Position& p, const Position::MoveInfo & moveInfo, const bool noNN
    return true;
 }
 
-void applyMoveNNUEUpdate(Position & p, const Position::MoveInfo & moveInfo){
+void unmakeMove(Position& p, const Position::MoveInfo & moveInfo, const Position::UndoInfo & undo) {
+   START_TIMER
+   const Color us = undo.c;
+   if (isCastling(moveInfo.type)) {
+      const CastlingTypes ct       = (moveInfo.type == T_wks || moveInfo.type == T_bks) ? CT_OO : CT_OOO;
+      const Square        rookFrom = p.rootInfo().rooksInit[us][ct];
+      const Square        rookDest = correctedRookDestSq[moveInfo.type];
+      const Piece         pk       = us == Co_White ? P_wk : P_bk;
+      const Piece         pr       = us == Co_White ? P_wr : P_br;
+      // remove both pieces first, squares can overlap in FRC
+      BBTools::unSetBit(p, moveInfo.to, pk);
+      BBTools::unSetBit(p, rookDest, pr);
+      BB::_unSetBit(p.allPieces[us], moveInfo.to);
+      BB::_unSetBit(p.allPieces[us], rookDest);
+      p.board(moveInfo.to) = P_none;
+      p.board(rookDest)    = P_none;
+      BBTools::setBit(p, undo.king[us], pk);
+      BBTools::setBit(p, rookFrom, pr);
+      BB::_setBit(p.allPieces[us], undo.king[us]);
+      BB::_setBit(p.allPieces[us], rookFrom);
+      p.board(undo.king[us]) = pk;
+      p.board(rookFrom)      = pr;
+   }
+   else {
+      // moved piece (or promoted one) goes back
+      BBTools::unSetBit(p, moveInfo.to);
+      BB::_unSetBit(p.allPieces[us], moveInfo.to);
+      BBTools::setBit(p, moveInfo.from, moveInfo.fromP);
+      BB::_setBit(p.allPieces[us], moveInfo.from);
+      p.board(moveInfo.from) = moveInfo.fromP;
+      p.board(moveInfo.to)   = P_none;
+      if (moveInfo.type == T_ep) {
+         const Square epCapSq = static_cast<Square>(undo.ep + (us == Co_White ? -8 : +8));
+         const Piece  pawn    = us == Co_White ? P_bp : P_wp;
+         BBTools::setBit(p, epCapSq, pawn);
+         BB::_setBit(p.allPieces[~us], epCapSq);
+         p.board(epCapSq) = pawn;
+      }
+      else if (moveInfo.isCapNoEP) {
+         BBTools::setBit(p, moveInfo.to, moveInfo.toP);
+         BB::_setBit(p.allPieces[~us], moveInfo.to);
+         p.board(moveInfo.to) = moveInfo.toP;
+      }
+   }
+   p.mat       = undo.mat;
 #ifdef WITH_NNUE
-   if (!DynamicConfig::useNNUE) return;
-   // if king is not moving, update nnue evaluator
+   p.associatedEvaluator = undo.associatedEvaluator;
+#endif
+   p.h         = undo.h;
+   p.ph        = undo.ph;
+   p.lastMove  = undo.lastMove;
+   p.moves     = undo.moves;
+   p.halfmoves = undo.halfmoves;
+   p.king      = undo.king;
+   p.ep        = undo.ep;
+   p.fifty     = undo.fifty;
+   p.castling  = undo.castling;
+   p.c         = undo.c;
+   STOP_AND_SUM_TIMER(Apply)
+}
+
+#ifdef WITH_NNUE
+namespace {
+// record on evaluator the move feature changes, p is the position after the move
+void setNNUEDelta(const Position & p, NNUEEvaluator & evaluator, const Position::MoveInfo & moveInfo){
+   evaluator.white.resetDelta();
+   evaluator.black.resetDelta();
    // this is based on initial position state (most notably ep square), 
    // all is available in the previously built moveInfo)
+   // ***be carefull here***, p.c has already been updated !!!
    if (Abs(moveInfo.fromP) != P_wk) {
-      // ***be carefull here***, p.c has already been updated !!!
-      if (p.c == Co_Black) updateNNUEEvaluator<Co_White>(p.evaluator(), moveInfo);
-      else updateNNUEEvaluator<Co_Black>(p.evaluator(), moveInfo);
-   }
-   // if a king was moved (including castling!!), reset nnue evaluator
-   // this is based on new position state !
-   else { 
-      p.resetNNUEEvaluator(p.evaluator(), ~p.c);
-      if (isCastling(moveInfo.type)){
-         p.resetNNUEEvaluator(p.evaluator(), p.c);
-      }
-      else{
-         // ***be carefull here***, p.c has already been updated !!!
-         if (p.c == Co_Black) updateNNUEEvaluatorThemOnly<Co_White>(p.evaluator(), moveInfo);
-         else updateNNUEEvaluatorThemOnly<Co_Black>(p.evaluator(), moveInfo);
-      }
+      if (p.c == Co_Black) setNNUEDelta<Co_White>(evaluator, moveInfo);
+      else setNNUEDelta<Co_Black>(evaluator, moveInfo);
    }
-#endif
+   // if a king was moved (including castling!!), a reset of its perspective is needed
+   else if (isCastling(moveInfo.type)){
+      evaluator.white.needRefresh_ = true;
+      evaluator.black.needRefresh_ = true;
+   }
+   else {
+      if (p.c == Co_Black) setNNUEDeltaThemOnly<Co_White>(evaluator, moveInfo);
+      else setNNUEDeltaThemOnly<Co_Black>(evaluator, moveInfo);
+   }
+}
 
+void checkNNUEEvaluator([[maybe_unused]] const Position & p){
 #ifdef DEBUG_NNUE_UPDATE
    Position      p2 = p;
    NNUEEvaluator evaluator;
@@ -279,7 +339,6 @@ void applyMoveNNUEUpdate(Position & p, const Position::MoveInfo & moveInfo){
    if (p2.evaluator() != p.evaluator()) {
       Logging::LogIt(Logging::logWarn) << "evaluator update error";
       Logging::LogIt(Logging::logWarn) << ToString(p);
-      Logging::LogIt(Logging::logWarn) << ToString(moveInfo.m);
       Logging::LogIt(Logging::logWarn) << ToString(p.lastMove);
       Logging::LogIt(Logging::logWarn) << p2.evaluator().white.active();
       Logging::LogIt(Logging::logWarn) << p2.evaluator().black.active();
@@ -288,9 +347,137 @@ void applyMoveNNUEUpdate(Position & p, const Position::MoveInfo & moveInfo){
       Logging::LogIt(Logging::logWarn) << p.evaluator().black.active();
       Logging::LogIt(Logging::logWarn) << backtrace();
    }
-#endif   
+#endif
+}
+} // namespace
+#endif
+
+void applyMoveNNUEUpdate([[maybe_unused]] Position & p, [[maybe_unused]] const Position::MoveInfo & moveInfo){
+#ifdef WITH_NNUE
+   if (!DynamicConfig::useNNUE) return;
+   NNUEEvaluator & evaluator = p.evaluator();
+   // evaluator copied from a lazy one not computed yet, simply reset it
+   if (!evaluator.computed()) {
+      p.resetNNUEEvaluator(evaluator);
+      return;
+   }
+   setNNUEDelta(p, evaluator, moveInfo);
+   // reset is based on new position state !
+   START_TIMER
+   if (!evaluator.white.needRefresh_) evaluator.white.applyDelta();
+   if (!evaluator.black.needRefresh_) evaluator.black.applyDelta();
+   STOP_AND_SUM_TIMER(UpdateNNUE)
+   if (evaluator.white.needRefresh_) p.resetNNUEEvaluator(evaluator, Co_White);
+   if (evaluator.black.needRefresh_) p.resetNNUEEvaluator(evaluator, Co_Black);
+   checkNNUEEvaluator(p);
+#endif
 }
 
+#ifdef WITH_NNUE
+void applyMoveNNUELazyUpdate(Position & p, NNUEEvaluator & evaluator, const Position::MoveInfo & moveInfo){
+   NNUEEvaluator & parent = p.evaluator();
+   assert(&parent != &evaluator);
+   p.associateEvaluator(evaluator);
+   if (!DynamicConfig::useNNUE) return;
+   evaluator.parent = &parent;
+   setNNUEDelta(p, evaluator, moveInfo);
+}
+
+void computeNNUEEvaluator(const Position & p, NNUEFinnyTable * finny){
+   NNUEEvaluator & evaluator = *p.associatedEvaluator;
+   if (evaluator.computed()) return;
+   START_TIMER
+   const bool whiteOk = evaluator.update<Co_White>();
+   const bool blackOk = evaluator.update<Co_Black>();
+   STOP_AND_SUM_TIMER(UpdateNNUE)
+   // reset is based on this position state
+   if (finny) {
+      if (!whiteOk) p.resetNNUEEvaluator(evaluator, Co_White, *finny);
+      if (!blackOk) p.resetNNUEEvaluator(evaluator, Co_Black, *finny);
+   }
+   else {
+      if (!whiteOk) p.resetNNUEEvaluator(evaluator, Co_White);
+      if (!blackOk) p.resetNNUEEvaluator(evaluator, Co_Black);
+   }
+   checkNNUEEvaluator(p);
+}
+#endif
+
+namespace MoveGen {
+
+LegalMasks::LegalMasks(const Position& p) {
+   if (!DynamicConfig::isKingMandatory()) return;
+   king = p.king[p.c];
+   if (!isValidSquare(king)) return;
+   valid = true;
+   const Color    opp       = ~p.c;
+   const BitBoard occupancy = p.occupancy();
+   // sliders aligned with the king are either checking it or pinning exactly one own piece
+   const BitBoard snipers = BBTools::attack<P_wb>(king, p.pieces_const<P_wb>(opp) | p.pieces_const<P_wq>(opp)) |
+                            BBTools::attack<P_wr>(king, p.pieces_const<P_wr>(opp) | p.pieces_const<P_wq>(opp));
+   BB::applyOn(snipers, [&](const Square & s){
+      const BitBoard blockers = BBTools::between(s, king) & occupancy;
+      if (!blockers) checkers |= SquareToBitboard(s);
+      else if (!(blockers & (blockers - 1)) && (blockers & p.allPieces[p.c])) {
+         pinned |= blockers;
+         pinners |= SquareToBitboard(s);
+      }
+   });
+   checkers |= BBTools::attack<P_wn>(king, p.pieces_const<P_wn>(opp)) | BBTools::attack<P_wp>(king, p.pieces_const<P_wp>(opp), occupancy, p.c);
+   if (checkers) {
+      if (checkers & (checkers - 1)) checkMask = emptyBitBoard;
+      else {
+         BitBoard checker = checkers;
+         checkMask = checkers | BBTools::between(BB::popBit(checker), king);
+      }
+   }
+}
+
+BitBoard LegalMasks::pinRay(const Square from) const {
+   BitBoard ray = emptyBitBoard;
+   BB::applyOn(pinners, [&](const Square & s){
+      const BitBoard b = BBTools::between(s, king);
+      if (b & SquareToBitboard(from)) ray = b | SquareToBitboard(s);
+   });
+   return ray;
+}
+
+bool isLegalEP(const Position& p, const Square from, const LegalMasks& masks) {
+   // both pawns leave their rank, and the checker can be the captured pawn, so sliders and checkers are looked at again
+   const Color    opp      = ~p.c;
+   const Square   epCapSq  = static_cast<Square>(p.ep + (p.c == Co_White ? -8 : +8));
+   const BitBoard occupancy = (p.occupancy() ^ SquareToBitboard(from) ^ SquareToBitboard(epCapSq)) | SquareToBitboard(p.ep);
+   if (masks.checkers & (p.pieces_const<P_wn>(opp) | p.pieces_const<P_wp>(opp)) & ~SquareToBitboard(epCapSq)) return false;
+   return !BBTools::attack<P_wb>(masks.king, p.pieces_const<P_wb>(opp) | p.pieces_const<P_wq>(opp), occupancy) &&
+          !BBTools::attack<P_wr>(masks.king, p.pieces_const<P_wr>(opp) | p.pieces_const<P_wq>(opp), occupancy);
+}
+
+bool isLegalCastling(const Position& p, const MType mt) {
+   // king path is checked by generation (and isPseudoLegal), but in FRC the castling rook can hide an attack on king landing square
+   const Square   kingLanding = correctedKingDestSq[mt];
+   const BitBoard occupancy   = (p.occupancy() & ~SquareToBitboard(p.king[p.c]) & ~SquareToBitboard(p.rootInfo().rooksInit[p.c][mt == T_wks || mt == T_bks ? CT_OO : CT_OOO])) |
+                                SquareToBitboard(kingLanding) | SquareToBitboard(correctedRookDestSq[mt]);
+   return !BBTools::isAttackedBB(p, kingLanding, p.c, occupancy);
+}
+
+bool isLegal(const Position& p, const Move m, const LegalMasks& masks) {
+   if (!masks.valid) {
+      Position p2 = p;
+      const Position::MoveInfo moveInfo(p2, m);
+      return applyMove(p2, moveInfo, true);
+   }
+   const MType  t    = Move2Type(m);
+   const Square from = Move2From(m);
+   const Square to   = Move2To(m);
+   if (t == T_ep) return isLegalEP(p, from, masks);
+   if (isCastling(t)) return !masks.checkers && isLegalCastling(p, t);
+   if (from == masks.king) return !BBTools::isAttackedBB(p, to, p.c, p.occupancy() & ~SquareToBitboard(from));
+   if (!(masks.checkMask & SquareToBitboard(to))) return false;
+   return !(masks.pinned & SquareToBitboard(from)) || (masks.pinRay(from) & SquareToBitboard(to));
+}
+
+} // namespace MoveGen
+
 ScoreType randomMover(const Position& p, PVList& pv, const bool isInCheck) {
    MoveList moves;
    MoveGen::generate<MoveGen::GP_all>(p, moves, false);
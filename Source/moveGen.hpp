@@ -74,10 +74,40 @@ struct CastlingTraits<T_bks>{
 
 void applyNull(Searcher& context, Position& pN);
 
-bool applyMove(Position& p, const Position::MoveInfo & moveInfo, const bool noNNUEUpdate = false);
+// noValidation can be used when the move is already known to be legal (see MoveGen::isLegal)
+bool applyMove(Position& p, const Position::MoveInfo & moveInfo, const bool noNNUEUpdate = false, const bool noValidation = false);
 
+// Make/unmake alternative to copy/make (see WITH_MAKE_UNMAKE and WITH_MAKE_UNMAKE_SEARCH) : take back a move applied on p,
+// moveInfo and undo being built from p before applyMove (even if it returned false).
+// NNUE evaluator shall not have been updated in place.
+void unmakeMove(Position& p, const Position::MoveInfo & moveInfo, const Position::UndoInfo & undo);
+
+// Apply a move (never updating NNUE in place) and take it back when leaving the scope
+struct ScopedMove {
+   ScopedMove(Position& p, const Position::MoveInfo & moveInfo, const bool noValidation = false):
+       _p(p), _moveInfo(moveInfo), _undo(p), valid(applyMove(p, moveInfo, true, noValidation)) {}
+   ~ScopedMove() { unmakeMove(_p, _moveInfo, _undo); }
+   ScopedMove(const ScopedMove&) = delete;
+   ScopedMove& operator=(const ScopedMove&) = delete;
+
+   Position&                      _p;
+   const Position::MoveInfo &     _moveInfo;
+   const Position::UndoInfo       _undo;
+   const bool                     valid; // false if move was not legal
+};
+
+// update associated NNUE evaluator right now
 void applyMoveNNUEUpdate(Position & p, const Position::MoveInfo & moveInfo);
 
+#ifdef WITH_NNUE
+// associate evaluator to p (still sharing its parent evaluator) and only record
+// the move feature changes, accumulators will be computed by computeNNUEEvaluator if needed
+void applyMoveNNUELazyUpdate(Position & p, NNUEEvaluator & evaluator, const Position::MoveInfo & moveInfo);
+
+// compute associated evaluator accumulators (from last computed ancestor or by a reset, using finny table if given)
+void computeNNUEEvaluator(const Position & p, NNUEFinnyTable * finny = nullptr);
+#endif
+
 [[nodiscard]] ScoreType randomMover(const Position& p, PVList& pv, const bool isInCheck);
 
 [[nodiscard]] bool isPseudoLegal(const Position& p, const Move m);
@@ -86,14 +116,39 @@ namespace MoveGen {
 
 enum GenPhase { GP_all = 0, GP_cap = 1, GP_quiet = 2, GP_evasion = 3 };
 
+// Side to move pinned pieces and check mask, computed once per node.
+// Used by the legal generator and to check legality before copy/apply.
+struct LegalMasks {
+   explicit LegalMasks(const Position& p);
+   BitBoard checkers  {emptyBitBoard};
+   BitBoard checkMask {~emptyBitBoard}; // non king moves must capture or block the checker (none if double check)
+   BitBoard pinned    {emptyBitBoard};
+   BitBoard pinners   {emptyBitBoard};
+   Square   king      {INVALIDSQUARE};
+   bool     valid     {false}; // no king (variants), legality is left to applyMove
+   [[nodiscard]] BitBoard pinRay(const Square from) const; // squares a pinned piece can go to
+};
+
+// legality of a pseudo-legal move
+[[nodiscard]] bool isLegal(const Position& p, const Move m, const LegalMasks& masks);
+[[nodiscard]] bool isLegalEP(const Position& p, const Square from, const LegalMasks& masks);
+[[nodiscard]] bool isLegalCastling(const Position& p, const MType mt);
+
+#ifdef USE_LEGAL_MOVEGEN
+inline constexpr bool legalMoveGen = true;
+#else
+inline constexpr bool legalMoveGen = false;
+#endif
+
 FORCE_FINLINE void addMove(Square from, Square to, MType type, MoveList& moves) {
    assert(isValidSquare(from));
    assert(isValidSquare(to));
    moves.emplace_back(ToMove(from, to, type, 0));
 }
 
-template<GenPhase phase = GP_all> 
-void generateSquare(const Position& p, MoveList& moves, const Square from) {
+template<GenPhase phase = GP_all, bool legal = false> 
+void generateSquare(const Position& p, MoveList& moves, const Square from, [[maybe_unused]] const LegalMasks* masks = nullptr) {
+   static_assert(!legal || phase != GP_evasion, "legal generation uses check mask, not evasion");
    assert(isValidSquare(from));
 #ifdef DEBUG_GENERATION
    if (from == INVALIDSQUARE) Logging::LogIt(Logging::logFatal) << "invalid square";
@@ -134,6 +189,14 @@ void generateSquare(const Position& p, MoveList& moves, const Square from) {
       //std::cout << ToString(attacker) << std::endl;
       //std::cout << ToString(sliderRay) << std::endl;
    }
+   // legal generation : other pieces than king shall answer check and stay on their pin ray
+   BitBoard legalTarget = ~emptyBitBoard;
+   if constexpr (legal) {
+      if (ptype != P_wk) {
+         legalTarget = masks->checkMask;
+         if (masks->pinned & SquareToBitboard(from)) legalTarget &= masks->pinRay(from);
+      }
+   }
    if (ptype != P_wp) {
       BitBoard bb = BBTools::pfCoverage[ptype - 1](from, occupancy, p.c) & ~myPieceBB;
       if (phase == GP_cap){
@@ -152,6 +215,14 @@ void generateSquare(const Position& p, MoveList& moves, const Square from) {
          else
             bb &= attacker | sliderRay;
       }
+      if constexpr (legal) {
+         if (ptype == P_wk) {
+            // all opponent threats at once (king removed from occupancy), instead of looking at each target square
+            if (bb) bb &= ~BBTools::attackedSet(p, side, occupancy & ~SquareToBitboard(from));
+         }
+         else
+            bb &= legalTarget;
+      }
       BB::applyOn(bb, [&](const Square & to){
          const bool isCap = (phase == GP_cap) || ((oppPieceBB & SquareToBitboard(to)) != emptyBitBoard);
          if (isCap) addMove(from, to, T_capture, moves);
@@ -179,7 +250,8 @@ void generateSquare(const Position& p, MoveList& moves, const Square from) {
             if ((p.castling & CastlingTraits<mt>::cr) &&
                (((BBTools::between(p.king[c], CastlingTraits<mt>::kingLanding) | CastlingTraits<mt>::kingLandingBB | BBTools::between(to, CastlingTraits<mt>::rookLanding) | CastlingTraits<mt>::rookLandingBB) 
                    & ~BBTools::mask[to].bbsquare & ~BBTools::mask[p.king[c]].bbsquare) & occupancy) == emptyBitBoard &&
-               !isAttacked(p, BBTools::between(p.king[c], CastlingTraits<mt>::kingLanding) | SquareToBitboard(p.king[c]) | CastlingTraits<mt>::kingLandingBB)){
+               !isAttacked(p, BBTools::between(p.king[c], CastlingTraits<mt>::kingLanding) | SquareToBitboard(p.king[c]) | CastlingTraits<mt>::kingLandingBB) &&
+               (!legal || isLegalCastling(p, mt))){
               addMove(from, to, mt, moves);
             }
          };
@@ -198,6 +270,7 @@ void generateSquare(const Position& p, MoveList& moves, const Square from) {
       BitBoard pawnmoves = emptyBitBoard;
       if (phase != GP_quiet) pawnmoves = BBTools::mask[from].pawnAttack[p.c] & ~myPieceBB & oppPieceBB;
       if (phase == GP_evasion) pawnmoves &= attacker;
+      if constexpr (legal) pawnmoves &= legalTarget;
       BB::applyOn(pawnmoves, [&](const Square & to){
          if ((SquareToBitboard(to) & BB::rank1_or_rank8) == emptyBitBoard) addMove(from, to, T_capture, moves);
          else {
@@ -212,6 +285,7 @@ void generateSquare(const Position& p, MoveList& moves, const Square from) {
       if (phase != GP_cap) pawnmoves |= BBTools::mask[from].push[p.c] & ~occupancy;
       if ((phase != GP_cap) && (BBTools::mask[from].push[p.c] & occupancy) == emptyBitBoard) pawnmoves |= BBTools::mask[from].dpush[p.c] & ~occupancy;
       if (phase == GP_evasion) pawnmoves &= sliderRay;
+      if constexpr (legal) pawnmoves &= legalTarget;
       BB::applyOn(pawnmoves, [&](const Square & to){
          if ((SquareToBitboard(to) & BB::rank1_or_rank8) == emptyBitBoard) addMove(from, to, T_std, moves);
          else {
@@ -225,28 +299,15 @@ void generateSquare(const Position& p, MoveList& moves, const Square from) {
       ///@todo evasion ep special case ?
       pawnmoves = emptyBitBoard;
       if (p.ep != INVALIDSQUARE && phase != GP_quiet) pawnmoves = BBTools::mask[from].pawnAttack[p.c] & ~myPieceBB & SquareToBitboard(p.ep);
+      if constexpr (legal) if (pawnmoves && !isLegalEP(p, from, *masks)) pawnmoves = emptyBitBoard;
       BB::applyOn(pawnmoves, [&](const Square & to){
          addMove(from, to, T_ep, moves);
       });
    }
 }
 
-template<GenPhase phase = GP_all> 
-void generate(const Position& p, MoveList& moves, const bool doNotClear = false) {
-   START_TIMER
-   if (!doNotClear) moves.clear();
-   BitBoard myPieceBBiterator = p.allPieces[p.c];
-   BB::applyOn(myPieceBBiterator, [&](const Square & k){ generateSquare<phase>(p, moves, k); });
-#ifdef DEBUG_GENERATION_LEGAL
-   for (auto m : moves) {
-      if (!isPseudoLegal(p, m)) {
-         Logging::LogIt(Logging::logError) << "Generation error, move not legal " << ToString(p);
-         Logging::LogIt(Logging::logError) << "move " << ToString(m);
-         Logging::LogIt(Logging::logFatal) << "previous " << ToString(p.lastMove);
-         assert(false);
-      }
-   }
-#endif
+// chess variants with mandatory moves
+inline void variantFilter(const Position& p, MoveList& moves) {
    // in anarchy chess, EP is mandatory
    if ( DynamicConfig::anarchy && p.ep != INVALIDSQUARE ){ // will be slow ... ///@todo better
       bool foundEP = false;
@@ -275,6 +336,43 @@ void generate(const Position& p, MoveList& moves, const bool doNotClear = false)
          moves = caps;
       }     
    }
+}
+
+template<GenPhase phase = GP_all> 
+void generate(const Position& p, MoveList& moves, const bool doNotClear = false) {
+   START_TIMER
+   if (!doNotClear) moves.clear();
+   BitBoard myPieceBBiterator = p.allPieces[p.c];
+   BB::applyOn(myPieceBBiterator, [&](const Square & k){ generateSquare<phase>(p, moves, k); });
+#ifdef DEBUG_GENERATION_LEGAL
+   for (auto m : moves) {
+      if (!isPseudoLegal(p, m)) {
+         Logging::LogIt(Logging::logError) << "Generation error, move not legal " << ToString(p);
+         Logging::LogIt(Logging::logError) << "move " << ToString(m);
+         Logging::LogIt(Logging::logFatal) << "previous " << ToString(p.lastMove);
+         assert(false);
+      }
+   }
+#endif
+   variantFilter(p, moves);
+   STOP_AND_SUM_TIMER(Generate)
+}
+
+// Legal moves generation (GP_evasion is not needed, check mask is used), masks are computed by the caller once per node.
+// Without king (variants), this falls back to pseudo-legal generation and applyMove shall still validate moves.
+template<GenPhase phase = GP_all>
+void generateLegal(const Position& p, MoveList& moves, const LegalMasks& masks, const bool doNotClear = false) {
+   constexpr GenPhase legalPhase = phase == GP_evasion ? GP_all : phase;
+   if (!masks.valid) {
+      generate<phase>(p, moves, doNotClear);
+      return;
+   }
+   START_TIMER
+   if (!doNotClear) moves.clear();
+   // only king moves when double check
+   BitBoard myPieceBBiterator = (masks.checkers & (masks.checkers - 1)) ? SquareToBitboard(masks.king) : p.allPieces[p.c];
+   BB::applyOn(myPieceBBiterator, [&](const Square & k){ generateSquare<legalPhase, true>(p, moves, k, &masks); });
+   variantFilter(p, moves);
    STOP_AND_SUM_TIMER(Generate)
 }
 
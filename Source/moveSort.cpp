@@ -1,6 +1,7 @@
 #include "moveSort.hpp"
 
 #include "logging.hpp"
+#include "moveGen.hpp"
 #include "searcher.hpp"
 
 /* Moves are sorted this way
@@ -58,7 +59,7 @@ void MoveSorter::computeScore(Move& m) const {
          s += (ScaleScore(pst[ColorSquarePstHelper<C>(to)] - pst[ColorSquarePstHelper<C>(from)] + pstOpp[ColorSquarePstHelper<~C>(to)], gp))/2;
 
          if (useSEE && !isInCheck) {
-            const ScoreType see = Searcher::SEE(p, m);
+            const ScoreType see = Searcher::SEE(p, m, attacks);
             s += see;
             // recapture bonus
             if (isValidMove(p.lastMove) && isCapture(p.lastMove) && to == Move2To(p.lastMove)) s += 512;
@@ -69,7 +70,7 @@ void MoveSorter::computeScore(Move& m) const {
             // recapture (> max MVVLVA value)
             if (isValidMove(p.lastMove) && isCapture(p.lastMove) && to == Move2To(p.lastMove)) s += 512;
             // MVVLVA [0 400] + cap history (HISTORY_MAX = 1024)
-            s += (8 * SearchConfig::MvvLvaScores[ppOpp - 1][pp - 1] + context.historyT.historyCap[PieceIdx(p.board_const(from))][to][ppOpp-1]) / 4;
+            s += (8 * SearchConfig::MvvLvaScores[ppOpp - 1][pp - 1] + context.historyT.cap(p.board_const(from), to, ppOpp)) / 4;
          }
       }
 
@@ -89,12 +90,12 @@ void MoveSorter::computeScore(Move& m) const {
             // History
             const Square correctedTo = correctedMove2ToKingDest(m);
             const Piece pp = p.board_const(from);
-            s += context.historyT.history[p.c][from][correctedTo] / 3;     // +/- HISTORY_MAX = 1024
-            s += context.historyT.historyP[PieceIdx(pp)][correctedTo] / 3; // +/- HISTORY_MAX = 1024
-            s += context.getCMHScore(p, from, correctedTo, cmhPtr) / 3;    // +/- HISTORY_MAX = 1024
+            s += context.historyT.history[p.c][from][correctedTo] / 3;          // +/- HISTORY_MAX = 1024
+            s += context.historyT.historyP[p.c][Abs(pp) - 1][correctedTo] / 3; // +/- HISTORY_MAX = 1024
+            s += context.getCMHScore(p, from, correctedTo, cmhPtr) / 3;         // +/- HISTORY_MAX = 1024
             if (!isCastling(m)) {
                // move (safely) leaving threat square from null move search
-               if (!isInCheck && refutation != INVALIDMINIMOVE && from == correctedMove2ToKingDest(refutation) && Searcher::SEE_GE(p, m, -80)) s += 512;
+               if (!isInCheck && refutation != INVALIDMINIMOVE && from == correctedMove2ToKingDest(refutation) && Searcher::SEE_GE(p, m, -80, attacks)) s += 512;
                // always use PST to compensate low value history
                const auto & pst = EvalConfig::PST[Abs(pp) - 1];
                s += (ScaleScore(pst[ColorSquarePstHelper<C>(correctedTo)] - pst[ColorSquarePstHelper<C>(from)], gp))/2;
@@ -116,10 +117,11 @@ void MoveSorter::score(const Searcher&    context,
                        const bool         useSEE,
                        const bool         isInCheck,
                        const TT::Entry*   e,
-                       const MiniMove     refutation) {
+                       const MiniMove     refutation,
+                       const BBTools::AttackMap* attacks) {
    START_TIMER
    if (moves.size() < 2) return;
-   const MoveSorter ms(context, p, gp, height, cmhPtr, useSEE, isInCheck, e, refutation);
+   const MoveSorter ms(context, p, gp, height, cmhPtr, useSEE, isInCheck, e, refutation, attacks);
    if (p.c == Co_White) {
       for (auto & it : moves) { ms.computeScore<Co_White>(it); }
    }
@@ -138,8 +140,9 @@ void MoveSorter::scoreAndSort(const Searcher&    context,
                               const bool         useSEE,
                               const bool         isInCheck,
                               const TT::Entry*   e,
-                              const MiniMove     refutation) {
-   score(context, moves, p, gp, height, cmhPtr, useSEE, isInCheck, e, refutation);
+                              const MiniMove     refutation,
+                              const BBTools::AttackMap* attacks) {
+   score(context, moves, p, gp, height, cmhPtr, useSEE, isInCheck, e, refutation, attacks);
    sort(moves);
 }
 
@@ -150,10 +153,158 @@ void MoveSorter::sort(MoveList& moves) {
 }
 
 const Move* MoveSorter::pickNext(MoveList& moves, size_t& begin) {
-   if (moves.begin() + begin == moves.end()) return nullptr;
+   return pickNext(moves, begin, moves.size());
+}
+
+const Move* MoveSorter::pickNext(MoveList& moves, size_t& begin, const size_t end) {
+   if (begin >= end) return nullptr;
+#ifdef USE_PARTIAL_SORT
    START_TIMER
-   const auto it = std::min_element(moves.begin() + begin, moves.end(), MoveSortOperator());
-   std::iter_swap(moves.begin() + begin, it);
+   // vectorized max scan : the key is the score (Move high bits) with the reversed index in low bits,
+   // so that the first best move is selected (as std::min_element with MoveSortOperator would)
+   static_assert(MAX_MOVE <= 0xFFFF);
+   const Move* data = moves.begin();
+   int32_t best = std::numeric_limits<int32_t>::min();
+#pragma omp simd reduction(max:best)
+   for (size_t i = begin; i < end; ++i) {
+      const int32_t key = static_cast<int32_t>(static_cast<uint32_t>(data[i]) & 0xFFFF0000u) | static_cast<int32_t>(0xFFFF - i);
+      best = key > best ? key : best;
+   }
+   std::swap(moves[begin], moves[0xFFFF - static_cast<size_t>(best & 0xFFFF)]);
    STOP_AND_SUM_TIMER(MoveSorting)
+#endif
    return &*(moves.begin() + (begin++)); // increment begin !
 }
+
+MovePicker::MovePicker(const MoveSorter& sorter, MoveList& moves, const Stage stage, const Move ttMove):
+    _sorter(sorter), _moves(moves), _ttMove(ttMove), _stage(stage), _staged(stage != MP_scoreAll) {
+   assert(stage == MP_scoreAll || stage == MP_genCap || stage == MP_scoreCap);
+}
+
+void MovePicker::scoreFrom(const size_t begin) {
+   if (begin >= _moves.size()) return;
+   START_TIMER
+   if (_sorter.p.c == Co_White) {
+      for (auto it = _moves.begin() + begin; it != _moves.end(); ++it) { _sorter.computeScore<Co_White>(*it); }
+   }
+   else {
+      for (auto it = _moves.begin() + begin; it != _moves.end(); ++it) { _sorter.computeScore<Co_Black>(*it); }
+   }
+   STOP_AND_SUM_TIMER(MoveScoring)
+#ifndef USE_PARTIAL_SORT
+   {
+      START_TIMER
+      std::sort(_moves.begin() + begin, _moves.end(), MoveSortOperator());
+      STOP_AND_SUM_TIMER(MoveSorting)
+   }
+#endif
+}
+
+bool MovePicker::isRefutation(const Move m) const {
+   for (uint8_t k = 0; k < _nbRefutations; ++k) {
+      if (sameMove(m, _refutations[k])) return true;
+   }
+   return false;
+}
+
+void MovePicker::addRefutation(const Move m) {
+   if (!isValidMove(m) || Move2Type(m) != T_std || sameMove(m, _ttMove) || isRefutation(m)) return;
+   // refutations are coming from other positions
+   Move r = ToMove(Move2From(m), Move2To(m), T_std, 0);
+   if (!isPseudoLegal(_sorter.p, r)) return;
+   if (_sorter.p.c == Co_White) _sorter.computeScore<Co_White>(r);
+   else _sorter.computeScore<Co_Black>(r);
+   _refutations[_nbRefutations++] = r;
+}
+
+void MovePicker::dropQuiets(const size_t begin) {
+   size_t n = begin;
+   for (size_t k = begin; k < _moves.size(); ++k) {
+      if (Move2Type(_moves[k]) != T_std) _moves[n++] = _moves[k];
+   }
+   while (_moves.size() > n) _moves.pop_back();
+}
+
+void MovePicker::skipQuiets() {
+   if (_skipQuiets || _stage < MP_goodCap || _stage >= MP_badCap) return; // not staged or too late
+   _skipQuiets = true;
+   if (_stage == MP_quiet) dropQuiets(_quietCur);
+}
+
+const Move* MovePicker::next() {
+   switch (_stage) {
+      case MP_scoreAll:
+         scoreFrom(0);
+         _stage = MP_all;
+         [[fallthrough]];
+      case MP_all:
+         while (const Move* m = MoveSorter::pickNext(_moves, _cur)) {
+            if (!sameMove(*m, _ttMove)) return m;
+         }
+         _stage = MP_done;
+         return nullptr;
+      case MP_genCap:
+         MoveGen::generate<MoveGen::GP_cap>(_sorter.p, _moves);
+         [[fallthrough]];
+      case MP_scoreCap:
+         scoreFrom(0);
+         _capEnd = _moves.size();
+         _stage  = MP_goodCap;
+         [[fallthrough]];
+      case MP_goodCap:
+         while (const Move* m = MoveSorter::pickNext(_moves, _cur, _capEnd)) {
+            // picked in score order, so all remaining captures are bad ones, they will be tried last
+            if (isCapture(*m) && !isPromotion(*m) && isBadCap(*m)) {
+               --_cur;
+               break;
+            }
+            if (!sameMove(*m, _ttMove)) return m;
+         }
+         // same order as in MoveSorter::computeScore
+         if (!_skipQuiets) {
+            const Searcher& context = _sorter.context;
+            const DepthType height  = _sorter.height;
+            addRefutation(context.killerT.killers[height][0]);
+            if (height > 1) addRefutation(context.killerT.killers[height - 2][0]);
+            if (isValidMove(_sorter.p.lastMove)) {
+               addRefutation(static_cast<Move>(context.counterT.counter[Move2From(_sorter.p.lastMove)][correctedMove2ToKingDest(_sorter.p.lastMove)]));
+            }
+            addRefutation(context.killerT.killers[height][1]);
+         }
+         _stage = MP_refutation;
+         [[fallthrough]];
+      case MP_refutation:
+         if (!_skipQuiets && _refutationIdx < _nbRefutations) return &_refutations[_refutationIdx++];
+         _stage = MP_genQuiet;
+         [[fallthrough]];
+      case MP_genQuiet:
+         _quietCur = _moves.size();
+         if (_skipQuiets) {
+            // only pawns about to promote and a king that can castle may have non std quiet moves
+            const Position& p     = _sorter.p;
+            const BitBoard  from  = (p.pieces_const<P_wp>(p.c) & BB::seventhRank[p.c]) |
+                                    ((p.castling & (p.c == Co_White ? C_w_all : C_b_all)) ? p.pieces_const<P_wk>(p.c) : emptyBitBoard);
+            BB::applyOn(from, [&](const Square & k) { MoveGen::generateSquare<MoveGen::GP_quiet>(p, _moves, k); });
+            dropQuiets(_quietCur);
+         }
+         else
+            MoveGen::generate<MoveGen::GP_quiet>(_sorter.p, _moves, true);
+         scoreFrom(_quietCur);
+         _stage = MP_quiet;
+         [[fallthrough]];
+      case MP_quiet:
+         while (const Move* m = MoveSorter::pickNext(_moves, _quietCur)) {
+            if (!sameMove(*m, _ttMove) && !isRefutation(*m)) return m;
+         }
+         _stage = MP_badCap;
+         [[fallthrough]];
+      case MP_badCap:
+         while (const Move* m = MoveSorter::pickNext(_moves, _cur, _capEnd)) {
+            if (!sameMove(*m, _ttMove)) return m;
+         }
+         _stage = MP_done;
+         [[fallthrough]];
+      case MP_done:
+      default: return nullptr;
+   }
+}
@@ -1,14 +1,17 @@
 #pragma once
 
+#include "attack.hpp"
 #include "definition.hpp"
 #include "tables.hpp"
 #include "timers.hpp"
 #include "transposition.hpp"
 
 /*!
- * Minic is not sorting move on the fly, but once and for all
  * MoveSorter is storing needed information and computeScore function
  * will give each move a score. After that, sort is called on the MoveList
+ * (or moves are picked one by one, see USE_PARTIAL_SORT).
+ * MovePicker is using it stage by stage so that quiet moves are only generated
+ * and scored if no capture or refutation produced a cut-off.
  * */
 
 struct MoveSortOperator {
@@ -28,8 +31,9 @@ struct MoveSorter {
               bool               _useSEE     = true,
               bool               _isInCheck  = false,
               const TT::Entry*   _e          = nullptr,
-              const MiniMove     _refutation = INVALIDMINIMOVE):
-       context(_context), p(_p), gp(_gp), height(_height), cmhPtr(_cmhPtr), useSEE(_useSEE), isInCheck(_isInCheck), e(_e), refutation(_refutation) {
+              const MiniMove     _refutation = INVALIDMINIMOVE,
+              const BBTools::AttackMap* _attacks = nullptr):
+       context(_context), p(_p), gp(_gp), height(_height), cmhPtr(_cmhPtr), useSEE(_useSEE), isInCheck(_isInCheck), e(_e), refutation(_refutation), attacks(_attacks) {
       assert(e == nullptr || e->h != nullHash);
    }
 
@@ -44,6 +48,7 @@ struct MoveSorter {
    const DepthType    height;
    const CMHPtrArray& cmhPtr;
    const float        gp;
+   const BBTools::AttackMap* attacks; // optional, makes SEE faster
 
    static void score(const Searcher&    context,
                      MoveList&          moves,
@@ -54,7 +59,8 @@ struct MoveSorter {
                      const bool         useSEE     = true,
                      const bool         isInCheck  = false,
                      const TT::Entry*   e          = nullptr,
-                     const MiniMove     refutation = INVALIDMINIMOVE);
+                     const MiniMove     refutation = INVALIDMINIMOVE,
+                     const BBTools::AttackMap* attacks = nullptr);
 
    static void scoreAndSort(const Searcher&    context,
                             MoveList&          moves,
@@ -65,9 +71,76 @@ struct MoveSorter {
                             const bool         useSEE     = true,
                             const bool         isInCheck  = false,
                             const TT::Entry*   e          = nullptr,
-                            const MiniMove     refutation = INVALIDMINIMOVE);
+                            const MiniMove     refutation = INVALIDMINIMOVE,
+                            const BBTools::AttackMap* attacks = nullptr);
 
    static void sort(MoveList& moves);
 
    [[nodiscard]] static const Move* pickNext(MoveList& moves, size_t& begin);
+   [[nodiscard]] static const Move* pickNext(MoveList& moves, size_t& begin, const size_t end);
+};
+
+#ifdef USE_STAGED_MOVEGEN
+inline constexpr bool stagedMoveGen = true;
+#else
+inline constexpr bool stagedMoveGen = false;
+#endif
+
+/*!
+ * Staged move picker, in staged mode (USE_STAGED_MOVEGEN) moves are generated and scored only when needed :
+ *  - TT move : tried by the caller before any generation (validated by isPseudoLegal in TT::getEntry), only skipped here
+ *  - good captures (SEE)
+ *  - killers and counter move, not generated so also validated with isPseudoLegal
+ *  - quiet moves
+ *  - bad captures
+ * Otherwise (default, root, evasion, qsearch, variants) the given move list is scored at once and picked by score.
+ * Picked moves are not copied, applyOnTried walks them where they already are (the TT move first).
+ */
+struct MovePicker {
+   enum Stage : uint8_t { MP_scoreAll = 0, MP_all, MP_genCap, MP_scoreCap, MP_goodCap, MP_refutation, MP_genQuiet, MP_quiet, MP_badCap, MP_done };
+
+   // moves is the given list in MP_scoreAll mode, captures already generated with MP_scoreCap, or nothing yet with MP_genCap
+   MovePicker(const MoveSorter& sorter, MoveList& moves, const Stage stage, const Move ttMove = INVALIDMOVE);
+
+   [[nodiscard]] const Move* next();
+
+   // late move pruning triggered : go on with bad captures, std quiet moves are not generated nor scored anymore
+   // (quiet promotions and castling, never pruned this way, are still given before bad captures)
+   void skipQuiets();
+
+   // calls f on every move already given by next() (and the TT move), in picking order when not staged
+   template<typename F> void applyOnTried(F&& f) const {
+      if (!_staged) {
+         // picked moves are kept at the front of the list
+         for (size_t k = 0; k < _cur; ++k) f(_moves[k]);
+         return;
+      }
+      if (isValidMove(_ttMove)) f(_ttMove);
+      for (size_t k = 0; k < std::min(_cur, _capEnd); ++k) {
+         if (!sameMove(_moves[k], _ttMove)) f(_moves[k]);
+      }
+      for (uint8_t k = 0; k < _refutationIdx; ++k) f(_refutations[k]);
+      for (size_t k = _capEnd; k < _quietCur; ++k) {
+         if (!sameMove(_moves[k], _ttMove) && !isRefutation(_moves[k])) f(_moves[k]);
+      }
+   }
+
+  private:
+   void scoreFrom(const size_t begin);
+   void addRefutation(const Move m);
+   void dropQuiets(const size_t begin);
+   [[nodiscard]] bool isRefutation(const Move m) const;
+
+   const MoveSorter& _sorter;
+   MoveList&        _moves;
+   array1d<Move, 4> _refutations;
+   uint8_t          _nbRefutations = 0;
+   uint8_t          _refutationIdx = 0;
+   size_t           _cur           = 0; // next move to pick (all moves or captures)
+   size_t           _capEnd        = 0;
+   size_t           _quietCur      = 0;
+   const Move       _ttMove;
+   Stage            _stage;
+   const bool       _staged;
+   bool             _skipQuiets    = false;
 };
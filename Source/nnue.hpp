@@ -40,6 +40,25 @@ inline void init() {
 
 using NNUEEvaluator = nnue::NNUEEval<NNUEWrapper::nnueNType, NNUEWrapper::quantization>;
 
+// "Finny table" : a per thread cache of the last accumulator computed for each perspective and king square
+// together with the pieces it was computed from. A refresh (king move) then only applies the difference.
+struct NNUEFinnyEntry {
+   using FT = decltype(NNUEEvaluator::white);
+   decltype(FT::active_) active;
+   array2d<BitBoard, 2, 6> pieces {}; // [us/them][piece type - 1]
+   bool valid {false};
+};
+
+struct NNUEFinnyTable {
+   array2d<NNUEFinnyEntry, 2, NbSquare> entries; // [perspective][king square]
+
+   // shall be called if net is changed
+   void clear() {
+      for (auto & perspective : entries)
+         for (auto & e : perspective) e.valid = false;
+   }
+};
+
 namespace FeatureIdx {
 
 inline constexpr size_t major = 64 * 12;
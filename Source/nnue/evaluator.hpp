@@ -18,31 +18,66 @@ struct NNUEEval : Sided<NNUEEval<NT, Q>, FeatureTransformer<NT, Q>> {
    FeatureTransformer<NT, Q> white;
    FeatureTransformer<NT, Q> black;
 
-   // status of the FeatureTransformers
-   // if dirty, then un update/reset is necessary
-   bool dirty = true;
+   // lazy update : evaluator from which the changes recorded in white and black are to be applied
+   // (nullptr if this one is always computed by a reset)
+   NNUEEval<NT, Q>* parent = nullptr;
 
    static constexpr int nbuckets {NNUEWeights<NT, Q>::nbuckets};
    static constexpr int bucketDivisor {NNUEWeights<NT, Q>::bucketDivisor};
 
    FORCE_FINLINE void clear() {
-      dirty = true;
+      parent = nullptr;
       white.clear();
       black.clear();
    }
 
    FORCE_FINLINE void clear(Color color) {
-      dirty = true;
       if (color == Co_White)
          white.clear();
       else
          black.clear();
    }
 
+   [[nodiscard]] FORCE_FINLINE bool computed() const { return white.computed_ && black.computed_; }
+
+   // compute c perspective accumulator from the last computed ancestor
+   // returns false if not possible (a king move in between), a reset is then needed
+   template<Color c> bool update() {
+      auto & ft = this->template us<c>();
+      if (ft.computed_) return true;
+      if (ft.needRefresh_ || !parent || !parent->template update<c>()) return false;
+      ft.updateFrom(parent->template us<c>());
+      return true;
+   }
+
    using BT = typename Quantization<Q>::BT;
+   using AIT = typename Quantization<Q>::AIT;
 
    constexpr float propagate(Color c, const int npiece) const {
-      assert(!dirty);
+      if constexpr (Quantization<Q>::innerInt) return propagateInt(c, npiece);
+      else return propagateFloat(c, npiece);
+   }
+
+   // fully integer inner layers
+   float propagateInt(Color c, const int npiece) const {
+      static_assert(Quantization<Q>::innerInt);
+      assert(computed());
+      using QT = Quantization<Q>;
+      const auto & w_x {white.active()};
+      const auto & b_x {black.active()};
+      const int phase = std::min(nbuckets-1, (npiece-1) / bucketDivisor);
+      const auto & layer = weights.innerLayer[phase];
+      const auto x0 = (c == Co_White ? splice(w_x, b_x) : splice(b_x, w_x)).template activateInt<AIT, QT::inputToInnerShift, QT::innerActMax>();
+      const auto x1 = layer.fc0.forwardInt(x0).template activateInt<AIT, QT::innerWShift, QT::innerActMax>();
+      const auto x2 = splice(x1, layer.fc1.forwardInt(x1).template activateInt<AIT, QT::innerWShift, QT::innerActMax>());
+      const auto x3 = splice(x2, layer.fc2.forwardInt(x2).template activateInt<AIT, QT::innerWShift, QT::innerActMax>());
+      const float val = static_cast<float>(layer.fc3.forwardInt(x3).data[0]) / static_cast<float>(1 << (QT::innerWShift + QT::innerActShift));
+      return val / QT::outFactor;
+   }
+
+   // float inner layers (also used as a reference for the integer path)
+   constexpr float propagateFloat(Color c, const int npiece) const {
+      assert(computed());
       const auto & w_x {white.active()};
       const auto & b_x {black.active()};
       const auto x0 = (c == Co_White ? splice(w_x, b_x) : splice(b_x, w_x));//.apply_(activationInput<BT, Q>);
@@ -19,9 +19,22 @@ struct FeatureTransformer {
 
    const StackVector<BIT, firstInnerLayerSize, Q> & active() const { return active_; }
 
+   // lazy update : feature changes relative to the parent accumulator
+   // are only recorded at make move time and applied when needed
+   static constexpr int maxDelta = 2;
+   array1d<uint32_t, maxDelta> added_ {0, 0};
+   array1d<uint32_t, maxDelta> removed_ {0, 0};
+   uint8_t nAdded_ {0};
+   uint8_t nRemoved_ {0};
+   bool computed_ {true};     // active_ is up to date
+   bool needRefresh_ {false}; // cannot be computed from parent (king moved)
+
    FORCE_FINLINE void clear() {
       assert(weights_);
       active_.from(weights_->b);
+      nAdded_ = nRemoved_ = 0;
+      needRefresh_ = false;
+      computed_ = true;
    }
 
    FORCE_FINLINE void insert(const size_t idx) {
@@ -34,6 +47,48 @@ struct FeatureTransformer {
       weights_->eraseIdx(idx, active_);
    }
 
+   // start recording changes relative to a parent accumulator
+   FORCE_FINLINE void resetDelta() {
+      nAdded_ = nRemoved_ = 0;
+      needRefresh_ = false;
+      computed_ = false;
+   }
+
+   FORCE_FINLINE void pushAdded(const size_t idx) {
+      assert(nAdded_ < maxDelta);
+      added_[nAdded_++] = static_cast<uint32_t>(idx);
+   }
+
+   FORCE_FINLINE void pushRemoved(const size_t idx) {
+      assert(nRemoved_ < maxDelta);
+      removed_[nRemoved_++] = static_cast<uint32_t>(idx);
+   }
+
+   // apply recorded changes on current accumulator
+   FORCE_FINLINE void applyDelta() {
+      assert(!needRefresh_);
+      weights_->updateIdx(active_, active_, added_.data(), nAdded_, removed_.data(), nRemoved_);
+      nAdded_ = nRemoved_ = 0;
+      computed_ = true;
+   }
+
+   // set accumulator from an already computed one (see NNUEFinnyTable)
+   FORCE_FINLINE void refreshFrom(const StackVector<BIT, firstInnerLayerSize, Q>& acc) {
+      active_ = acc;
+      nAdded_ = nRemoved_ = 0;
+      needRefresh_ = false;
+      computed_ = true;
+   }
+
+   // apply recorded changes on parent accumulator
+   FORCE_FINLINE void updateFrom(const FeatureTransformer<NT, Q>& parent) {
+      assert(parent.computed_);
+      assert(!needRefresh_);
+      weights_->updateIdx(parent.active_, active_, added_.data(), nAdded_, removed_.data(), nRemoved_);
+      nAdded_ = nRemoved_ = 0;
+      computed_ = true;
+   }
+
    FeatureTransformer(const InputLayer<NT, inputLayerSize, firstInnerLayerSize, Q>* src): weights_ {src} { clear(); }
 
    FeatureTransformer() = delete;
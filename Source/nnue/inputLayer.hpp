@@ -35,6 +35,29 @@ struct InputLayer {
       x.sub_(wPtr);
    }
 
+   // x = src + added rows - removed rows, accumulator is only read and written once (x and src may be the same)
+   static constexpr int maxUpdateIdx = 4;
+   FORCE_FINLINE void updateIdx(const StackVector<BIT, nbB, Q>& src, StackVector<BIT, nbB, Q>& x,
+                                const uint32_t* added, const int nAdded, const uint32_t* removed, const int nRemoved) const {
+      assert(nAdded <= maxUpdateIdx && nRemoved <= maxUpdateIdx);
+      const WIT* adds[maxUpdateIdx];
+      const WIT* subs[maxUpdateIdx];
+      for (int k = 0; k < nAdded; ++k) adds[k] = W + added[k] * dim1;
+      for (int k = 0; k < nRemoved; ++k) subs[k] = W + removed[k] * dim1;
+#ifdef USE_SIMD_INTRIN
+      if constexpr (std::is_same_v<BIT, WIT>) {
+         if (simdMultiUpdate<nbB>(x.data, src.data, adds, nAdded, subs, nRemoved)) return;
+      }
+#endif
+#pragma omp simd
+      for (size_t i = 0; i < nbB; ++i) {
+         BIT v = src.data[i];
+         for (int k = 0; k < nAdded; ++k) v += adds[k][i];
+         for (int k = 0; k < nRemoved; ++k) v -= subs[k][i];
+         x.data[i] = v;
+      }
+   }
+
    InputLayer<NT, dim0, dim1, Q>& load_(WeightsReader<NT>& ws) {
       ws.template streamWI<WIT, Q>(W, nbW).template streamBI<BIT, Q>(b, nbB);
       return *this;
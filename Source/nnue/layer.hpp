@@ -15,12 +15,21 @@ struct Layer {
 
    using BT = typename Quantization<Q>::BT;
    using WT = typename Quantization<Q>::WT;
+   using AIT = typename Quantization<Q>::AIT;
+   using WIIT = typename Quantization<Q>::WIIT;
+   using BIIT = typename Quantization<Q>::BIIT;
+
+   static constexpr bool innerInt = Quantization<Q>::innerInt;
 
    // Layer is always for inner layer, so we can safely use WT and BT
    // Always small enough to be statically allocated
    alignas(NNUEALIGNMENT) WT W[nbW];
    alignas(NNUEALIGNMENT) BT b[nbB];
 
+   // integer version of weights (always one row per output) and bias, only used by integer path
+   alignas(NNUEALIGNMENT) WIIT Wi[innerInt ? nbW : 1];
+   alignas(NNUEALIGNMENT) BIIT bi[innerInt ? nbB : 1];
+
    template<typename T> 
    constexpr StackVector<BT, dim1, Q> forward(const StackVector<T, dim0, Q>& x) const {
       StackVector<BT, dim1, Q> result;
@@ -35,8 +44,39 @@ struct Layer {
       return result; // RVO
    }
 
+   // output is in int32 with a scale of 2^(innerWShift + innerActShift)
+   constexpr StackVector<BIIT, dim1, Q> forwardInt(const StackVector<AIT, dim0, Q>& x) const {
+      static_assert(innerInt);
+      StackVector<BIIT, dim1, Q> result;
+      result.from(bi);
+      for (size_t i = 0; i < dim1; ++i) { result.data[i] += x.dotI8_(Wi + i * dim0); }
+      return result; // RVO
+   }
+
+   // build integer weights and bias from float ones, clamping and warning on overflow
+   void quantizeInner_() {
+      constexpr float fW = static_cast<float>(1 << Quantization<Q>::innerWShift);
+      constexpr float fB = static_cast<float>(1 << (Quantization<Q>::innerWShift + Quantization<Q>::innerActShift));
+      constexpr float maxW = static_cast<float>(std::numeric_limits<WIIT>::max());
+      int overflow = 0;
+      for (size_t i = 0; i < dim0; ++i) {
+         for (size_t j = 0; j < dim1; ++j) {
+#ifdef USE_SIMD_INTRIN
+            const float w = W[j * dim0 + i]; // already transposed on read
+#else
+            const float w = W[i * dim1 + j];
+#endif
+            if (std::fabs(w * fW) > maxW) ++overflow;
+            Wi[j * dim0 + i] = static_cast<WIIT>(std::clamp(std::round(w * fW), -maxW, maxW));
+         }
+      }
+      for (size_t j = 0; j < dim1; ++j) bi[j] = static_cast<BIIT>(std::round(b[j] * fB));
+      if (overflow) Logging::LogIt(Logging::logWarn) << "Overflow of " << overflow << " inner weights (clamped)";
+   }
+
    Layer<NT, dim0, dim1, Q>& load_(WeightsReader<NT>& ws) {
       ws.template streamW<WT>(W, nbW, dim0, dim1).template streamB<BT>(b, nbB);
+      if constexpr (innerInt) quantizeInner_();
       return *this;
    }
 
@@ -15,6 +15,11 @@ template<bool Q> struct Quantization {
    static constexpr WT scale {1};
    static constexpr float outFactor {1.f / 600.f};
    static float round(const float& x) { return x; }
+   // inner layers integer path is only available with quantization
+   static constexpr bool innerInt {false};
+   using AIT = uint8_t;
+   using WIIT = int8_t;
+   using BIIT = int32_t;
 };
 
 // When quantization is activated (on read) we try to store weights and
@@ -28,12 +33,32 @@ template<> struct Quantization<true> {
    static constexpr WT scale {512}; // 32*512 = 16384 and |weight| & |bias| < 0.6
    static constexpr float outFactor {1.f / 600.f};
    static float round(const float& x) { return std::round(x); }
+   // Inner layers can also be computed using only integers (see doc/) :
+   // activations are uint8 in [0,127] (1 being mapped to 128), weights are int8,
+   // bias and accumulation are int32, and clipped ReLU goes back to uint8
+#ifdef WITH_NNUE_INT8_INNER
+   static constexpr bool innerInt {true};
+#else
+   static constexpr bool innerInt {false};
+#endif
+   using AIT = uint8_t;  // activation type
+   using WIIT = int8_t;  // inner weight type
+   using BIIT = int32_t; // inner bias and accumulation type
+   static constexpr int innerActShift {7};      // activation 1 <=> 128
+   static constexpr int innerWShift {5};        // f = 32, so inner weights shall be in ]-4,4[
+   static constexpr int inputToInnerShift {2};  // from input layer scale (512) to activation scale (128)
+   static constexpr int innerActMax {127};
+   static_assert(static_cast<int>(scale) == 1 << (innerActShift + inputToInnerShift));
 };
 
 template<bool Q> inline void quantizationInfo() {
    if constexpr (Q) {
       Logging::LogIt(Logging::logInfo) << "Quantization info :";
       Logging::LogIt(Logging::logInfo) << "scale " << Quantization<true>::scale;
+      if constexpr (Quantization<true>::innerInt) {
+         Logging::LogIt(Logging::logInfo) << "inner layers using int8 weights (factor " << (1 << Quantization<true>::innerWShift)
+                                          << ") and int32 accumulation";
+      }
    }
    else {
       Logging::LogIt(Logging::logInfo) << "No quantization, using float net";
@@ -46,61 +46,69 @@ My gcc (and clang) gives those macros for simd extension :
 #include <smmintrin.h>
 #endif
 /** AVX **/
-#if defined(__AVX__) || defined(__FMA__)
+#if defined(__AVX__) || defined(__FMA__) || defined(WITH_CPU_DISPATCH)
 #include <immintrin.h>
 #endif
 
+#include "cpu.hpp"
+
+// With WITH_CPU_DISPATCH, the binary targets generic x86-64 and every kernel is built
+// for its own instruction set using target attributes, then selected at run time
+// using CPU::features.simdWidth. Otherwise only kernels allowed by the compiler target exist.
+#ifdef WITH_CPU_DISPATCH
+#define SIMD_TARGET_512 __attribute__((target("avx512f,avx512bw,avx2,fma")))
+#define SIMD_TARGET_256 __attribute__((target("avx2,fma")))
+#define SIMD_TARGET_128 __attribute__((target("sse4.1")))
+#else
+#define SIMD_TARGET_512
+#define SIMD_TARGET_256
+#define SIMD_TARGET_128
+#endif
+
 //----------------------------------
 // AVX512
 //----------------------------------
-#if defined(__AVX512VL__NONONO)
+#if (defined(__AVX512F__) || defined(WITH_CPU_DISPATCH)) && defined(USE_AVX512_SIMD)
 #define V_SIMD_512 512
 using v_f32_512 = __m512;
 inline constexpr auto v_nlanes_f32_512 = 16;
 #define v_add_f32_512    _mm512_add_ps
 #define v_mul_f32_512    _mm512_mul_ps
 #define v_muladd_f32_512 _mm512_fmadd_ps
-
-FORCE_FINLINE float v_sum_f32_256(__m256 a) {
-   __m256 sum_halves = _mm256_hadd_ps(a, a);
-   sum_halves        = _mm256_hadd_ps(sum_halves, sum_halves);
-   const __m128 lo   = _mm256_castps256_ps128(sum_halves);
-   const __m128 hi   = _mm256_extractf128_ps(sum_halves, 1);
-   const __m128 sum  = _mm_add_ps(lo, hi);
-   return _mm_cvtss_f32(sum);
+// same reduction order as _mm512_reduce_add_ps, whose half extractions pass an undefined source register
+SIMD_TARGET_512 FORCE_FINLINE float v_sum_f32_512(__m512 a) {
+   const __m256 hi  = _mm256_castpd_ps(_mm512_maskz_extractf64x4_pd(0xF, _mm512_castps_pd(a), 1));
+   const __m256 lo  = _mm256_castpd_ps(_mm512_maskz_extractf64x4_pd(0xF, _mm512_castps_pd(a), 0));
+   const __m256 s8  = _mm256_add_ps(hi, lo);
+   const __m128 s4  = _mm_add_ps(_mm256_extractf128_ps(s8, 1), _mm256_castps256_ps128(s8));
+   const __m128 s2  = _mm_add_ps(s4, _mm_movehl_ps(s4, s4));
+   return _mm_cvtss_f32(_mm_add_ss(s2, _mm_movehdup_ps(s2)));
 }
-
-FORCE_FINLINE float v_sum_f32_512(__m512 a) {
-   const __m256 low  = _mm512_castps512_ps256(a);
-   const __m256 high = _mm512_extractf32x8_ps(a,1);
-   return v_sum_f32_256(low+high);
-}
-
-#define v_load_f32_512(PTR) _mm512_load_ps((const __m512*)(PTR))
-#define v_zero_f32_512      _mm512_setzero_ps
-#define v_un_f32_512        _mm512_set1_ps
-#define v_max_f32_512       _mm512_max_ps
-#define v_min_f32_512       _mm512_min_ps
+#define v_load_f32_512   _mm512_load_ps
+#define v_zero_f32_512   _mm512_setzero_ps
+#define v_un_f32_512     _mm512_set1_ps
+// full mask zeroing forms, plain _mm512_max_ps/_mm512_min_ps pass an undefined source register (reported uninitialized by gcc 12)
+#define v_max_f32_512(a, b) _mm512_maskz_max_ps(0xFFFF, a, b)
+#define v_min_f32_512(a, b) _mm512_maskz_min_ps(0xFFFF, a, b)
 
 template<bool Q>
-__m256 reluLoad(const float * RESTRICT x, const __m256 & zero, const __m256 & un){
+SIMD_TARGET_512 __m512 reluLoad(const float * RESTRICT x, const __m512 & zero, const __m512 & un){
    if constexpr(Q)
       return v_max_f32_512(zero, v_min_f32_512(un ,v_load_f32_512(x)));
    else
       return v_max_f32_512(zero, v_load_f32_512(x));
 }
 
-
-FORCE_FINLINE void Log512(const __m512 & value){
+SIMD_TARGET_512 FORCE_FINLINE void Log512(const __m512 & value){
     constexpr size_t n = sizeof(__m512) / sizeof(float);
-    float buffer[n];
-    _mm512_store_ps((void*)buffer, value);
+    alignas(64) float buffer[n];
+    _mm512_store_ps(buffer, value);
     for (size_t i = 0; i < n; i++)
         std::cout << buffer[i] << " ";
     std::cout << std::endl;
 }
 
-template<size_t N, bool Q> [[nodiscard]] float simdDotProduct512(const float* RESTRICT x, const float* RESTRICT y) {
+template<size_t N, bool Q> [[nodiscard]] SIMD_TARGET_512 float simdDotProduct512(const float* RESTRICT x, const float* RESTRICT y) {
    constexpr int vstep    = v_nlanes_f32_512;
    constexpr int unrollx4 = N & (-vstep * 4);
    constexpr int unrollx  = N & -vstep;
@@ -128,24 +136,70 @@ template<size_t N, bool Q> [[nodiscard]] float simdDotProduct512(const float* RE
    //Log512(vsum0);
    return v_sum_f32_512(vsum0);
 }
+
+// accumulator update (input layer), x += y or x -= y
+// rows are NNUEALIGNMENT aligned but unaligned access is as fast in that case
+#if defined(__AVX512BW__) || defined(WITH_CPU_DISPATCH)
+#define V_SIMD_512_I16 512
+template<size_t N, bool ADD> SIMD_TARGET_512 void simdUpdateI16_512(int16_t* RESTRICT x, const int16_t* RESTRICT y) {
+   static_assert(N % 32 == 0);
+   for (size_t i = 0; i < N; i += 32) {
+      const __m512i a = _mm512_loadu_si512((const __m512i*)(x + i));
+      const __m512i b = _mm512_loadu_si512((const __m512i*)(y + i));
+      _mm512_storeu_si512((__m512i*)(x + i), ADD ? _mm512_add_epi16(a, b) : _mm512_sub_epi16(a, b));
+   }
+}
+#endif
+
+template<size_t N, bool ADD> SIMD_TARGET_512 void simdUpdateF32_512(float* RESTRICT x, const float* RESTRICT y) {
+   static_assert(N % 16 == 0);
+   for (size_t i = 0; i < N; i += 16) {
+      const __m512 a = _mm512_loadu_ps(x + i);
+      const __m512 b = _mm512_loadu_ps(y + i);
+      _mm512_storeu_ps(x + i, ADD ? _mm512_add_ps(a, b) : _mm512_sub_ps(a, b));
+   }
+}
+
+// fused accumulator update, x = src + sum(adds) - sum(subs), x and src may alias
+// number of rows are compile time constants so that everything is unrolled
+#ifdef V_SIMD_512_I16
+template<size_t N, int NA, int NS> SIMD_TARGET_512 void simdMultiUpdateI16_512(int16_t* x, const int16_t* src, const int16_t* const* adds, const int16_t* const* subs) {
+   static_assert(N % 32 == 0);
+   for (size_t i = 0; i < N; i += 32) {
+      __m512i a = _mm512_loadu_si512((const __m512i*)(src + i));
+      for (int k = 0; k < NA; ++k) a = _mm512_add_epi16(a, _mm512_loadu_si512((const __m512i*)(adds[k] + i)));
+      for (int k = 0; k < NS; ++k) a = _mm512_sub_epi16(a, _mm512_loadu_si512((const __m512i*)(subs[k] + i)));
+      _mm512_storeu_si512((__m512i*)(x + i), a);
+   }
+}
+#endif
+
+template<size_t N, int NA, int NS> SIMD_TARGET_512 void simdMultiUpdateF32_512(float* x, const float* src, const float* const* adds, const float* const* subs) {
+   static_assert(N % 16 == 0);
+   for (size_t i = 0; i < N; i += 16) {
+      __m512 a = _mm512_loadu_ps(src + i);
+      for (int k = 0; k < NA; ++k) a = _mm512_add_ps(a, _mm512_loadu_ps(adds[k] + i));
+      for (int k = 0; k < NS; ++k) a = _mm512_sub_ps(a, _mm512_loadu_ps(subs[k] + i));
+      _mm512_storeu_ps(x + i, a);
+   }
+}
 #endif
 
 //----------------------------------
 // AVX
 //----------------------------------
-#if defined(__AVX2__)
+#if defined(__AVX2__) || defined(WITH_CPU_DISPATCH)
 #define V_SIMD_256 256
 using v_f32_256 = __m256;
 inline constexpr auto v_nlanes_f32_256 = 8;
 #define v_add_f32_256    _mm256_add_ps
 #define v_mul_f32_256    _mm256_mul_ps
-#ifdef __FMA__
+#if defined(__FMA__) || defined(WITH_CPU_DISPATCH)
 #define v_muladd_f32_256 _mm256_fmadd_ps
 #else
-FORCE_FINLINE __m256 v_muladd_f32_256(__m256 a, __m256 b, __m256 c) { return v_add_f32_256(v_mul_f32_256(a, b), c); }
+SIMD_TARGET_256 FORCE_FINLINE __m256 v_muladd_f32_256(__m256 a, __m256 b, __m256 c) { return v_add_f32_256(v_mul_f32_256(a, b), c); }
 #endif
-#ifndef V_SIMD_512
-FORCE_FINLINE float v_sum_f32_256(__m256 a) {
+SIMD_TARGET_256 FORCE_FINLINE float v_sum_f32_256(__m256 a) {
    __m256 sum_halves = _mm256_hadd_ps(a, a);
    sum_halves        = _mm256_hadd_ps(sum_halves, sum_halves);
    const __m128 lo   = _mm256_castps256_ps128(sum_halves);
@@ -153,7 +207,6 @@ FORCE_FINLINE float v_sum_f32_256(__m256 a) {
    const __m128 sum  = _mm_add_ps(lo, hi);
    return _mm_cvtss_f32(sum);
 }
-#endif
 #define v_load_f32_256 _mm256_load_ps
 #define v_zero_f32_256 _mm256_setzero_ps
 #define v_un_f32_256   _mm256_set1_ps
@@ -161,14 +214,14 @@ FORCE_FINLINE float v_sum_f32_256(__m256 a) {
 #define v_min_f32_256  _mm256_min_ps
 
 template<bool Q>
-__m256 reluLoad(const float * RESTRICT x, const __m256 & zero, const __m256 & un){
+SIMD_TARGET_256 __m256 reluLoad(const float * RESTRICT x, const __m256 & zero, const __m256 & un){
    if constexpr(Q)
       return v_max_f32_256(zero, v_min_f32_256(un ,v_load_f32_256(x)));
    else
       return v_max_f32_256(zero, v_load_f32_256(x));
 }
 
-FORCE_FINLINE void Log256(const __m256 & value){
+SIMD_TARGET_256 FORCE_FINLINE void Log256(const __m256 & value){
     constexpr size_t n = sizeof(__m256) / sizeof(float);
     float buffer[n];
     _mm256_store_ps(buffer, value);
@@ -177,7 +230,7 @@ FORCE_FINLINE void Log256(const __m256 & value){
     std::cout << std::endl;
 }
 
-template<size_t N, bool Q> [[nodiscard]] float simdDotProduct256(const float* RESTRICT x, const float* RESTRICT y) {
+template<size_t N, bool Q> [[nodiscard]] SIMD_TARGET_256 float simdDotProduct256(const float* RESTRICT x, const float* RESTRICT y) {
    constexpr int vstep    = v_nlanes_f32_256;
    constexpr int unrollx4 = N & (-vstep * 4);
    constexpr int unrollx  = N & -vstep;
@@ -205,6 +258,44 @@ template<size_t N, bool Q> [[nodiscard]] float simdDotProduct256(const float* RE
    //Log256(vsum0);
    return v_sum_f32_256(vsum0);
 }
+
+template<size_t N, bool ADD> SIMD_TARGET_256 void simdUpdateI16_256(int16_t* RESTRICT x, const int16_t* RESTRICT y) {
+   static_assert(N % 16 == 0);
+   for (size_t i = 0; i < N; i += 16) {
+      const __m256i a = _mm256_loadu_si256((const __m256i*)(x + i));
+      const __m256i b = _mm256_loadu_si256((const __m256i*)(y + i));
+      _mm256_storeu_si256((__m256i*)(x + i), ADD ? _mm256_add_epi16(a, b) : _mm256_sub_epi16(a, b));
+   }
+}
+
+template<size_t N, bool ADD> SIMD_TARGET_256 void simdUpdateF32_256(float* RESTRICT x, const float* RESTRICT y) {
+   static_assert(N % 8 == 0);
+   for (size_t i = 0; i < N; i += 8) {
+      const __m256 a = _mm256_loadu_ps(x + i);
+      const __m256 b = _mm256_loadu_ps(y + i);
+      _mm256_storeu_ps(x + i, ADD ? _mm256_add_ps(a, b) : _mm256_sub_ps(a, b));
+   }
+}
+
+template<size_t N, int NA, int NS> SIMD_TARGET_256 void simdMultiUpdateI16_256(int16_t* x, const int16_t* src, const int16_t* const* adds, const int16_t* const* subs) {
+   static_assert(N % 16 == 0);
+   for (size_t i = 0; i < N; i += 16) {
+      __m256i a = _mm256_loadu_si256((const __m256i*)(src + i));
+      for (int k = 0; k < NA; ++k) a = _mm256_add_epi16(a, _mm256_loadu_si256((const __m256i*)(adds[k] + i)));
+      for (int k = 0; k < NS; ++k) a = _mm256_sub_epi16(a, _mm256_loadu_si256((const __m256i*)(subs[k] + i)));
+      _mm256_storeu_si256((__m256i*)(x + i), a);
+   }
+}
+
+template<size_t N, int NA, int NS> SIMD_TARGET_256 void simdMultiUpdateF32_256(float* x, const float* src, const float* const* adds, const float* const* subs) {
+   static_assert(N % 8 == 0);
+   for (size_t i = 0; i < N; i += 8) {
+      __m256 a = _mm256_loadu_ps(src + i);
+      for (int k = 0; k < NA; ++k) a = _mm256_add_ps(a, _mm256_loadu_ps(adds[k] + i));
+      for (int k = 0; k < NS; ++k) a = _mm256_sub_ps(a, _mm256_loadu_ps(subs[k] + i));
+      _mm256_storeu_ps(x + i, a);
+   }
+}
 #endif
 
 //----------------------------------
@@ -221,10 +312,10 @@ inline constexpr auto v_nlanes_f32_128 = 4;
 //#elif defined(__FMA4__)
 //#define v_muladd_f32_128 _mm_macc_ps
 #else
-FORCE_FINLINE __m128 v_muladd_f32_128(__m128 a, __m128 b, __m128 c) { return v_add_f32_128(v_mul_f32_128(a, b), c); }
+SIMD_TARGET_128 FORCE_FINLINE __m128 v_muladd_f32_128(__m128 a, __m128 b, __m128 c) { return v_add_f32_128(v_mul_f32_128(a, b), c); }
 #endif
-FORCE_FINLINE float v_sum_f32_128(__m128 a) {
-#ifdef __SSE3__
+SIMD_TARGET_128 FORCE_FINLINE float v_sum_f32_128(__m128 a) {
+#if defined(__SSE3__) || defined(WITH_CPU_DISPATCH)
    const __m128 sum_halves = _mm_hadd_ps(a, a);
    return _mm_cvtss_f32(_mm_hadd_ps(sum_halves, sum_halves));
 #else
@@ -242,14 +333,14 @@ FORCE_FINLINE float v_sum_f32_128(__m128 a) {
 #define v_min_f32_128  _mm_min_ps
 
 template<bool Q>
-__m128 reluLoad(const float * RESTRICT x, const __m128 & zero, const __m128 & un){
+SIMD_TARGET_128 __m128 reluLoad(const float * RESTRICT x, const __m128 & zero, const __m128 & un){
    if constexpr(Q)
       return v_max_f32_128(zero, v_min_f32_128(un ,v_load_f32_128(x)));
    else
       return v_max_f32_128(zero, v_load_f32_128(x));
 }
 
-FORCE_FINLINE void Log128(const __m128 & value){
+SIMD_TARGET_128 FORCE_FINLINE void Log128(const __m128 & value){
     constexpr size_t n = sizeof(__m128) / sizeof(float);
     float buffer[n];
     _mm_store_ps(buffer, value);
@@ -258,7 +349,7 @@ FORCE_FINLINE void Log128(const __m128 & value){
     std::cout << std::endl;
 }
 
-template<size_t N, bool Q> [[nodiscard]] float simdDotProduct128(const float* RESTRICT x, const float* RESTRICT y) {
+template<size_t N, bool Q> [[nodiscard]] SIMD_TARGET_128 float simdDotProduct128(const float* RESTRICT x, const float* RESTRICT y) {
    constexpr int vstep    = v_nlanes_f32_128;
    constexpr int unrollx4 = N & (-vstep * 4);
    constexpr int unrollx  = N & -vstep;
@@ -309,44 +400,217 @@ template<size_t N, bool Q> [[nodiscard]] float simdDotProductDefault(const float
    return dot;
 }
 
-template<size_t N, bool Q> [[nodiscard]] float simdDotProduct(const float* RESTRICT x, const float* RESTRICT y) {
-   size_t i  = 0;
+// widest kernels available in this build
+#if defined(V_SIMD_512)
+inline constexpr int simdWidthMax = 512;
+#elif defined(V_SIMD_256)
+inline constexpr int simdWidthMax = 256;
+#elif defined(V_SIMD_128)
+inline constexpr int simdWidthMax = 128;
+#else
+inline constexpr int simdWidthMax = 0;
+#endif
+
+// call f.template operator()<W>() with W the widest usable kernel width
+template<typename F> FORCE_FINLINE auto simdDispatch(F&& f) {
+#ifdef WITH_CPU_DISPATCH
+   switch (CPU::features.simdWidth) {
+#ifdef V_SIMD_512
+      case 512: return f.template operator()<512>();
+#endif
+      case 256: return f.template operator()<256>();
+      case 128: return f.template operator()<128>();
+      default:  return f.template operator()<0>();
+   }
+#else
+   return f.template operator()<simdWidthMax>();
+#endif
+}
+
+// each kernel only handles its own part of the remaining elements, N being the full size
+template<size_t N, bool Q, int W> [[nodiscard]] FORCE_FINLINE float simdDotProductW(const float* RESTRICT x, const float* RESTRICT y) {
    float dot = 0.0f;
    if constexpr (N <= 0) return dot;
 
 #if V_SIMD_512
-   if (N-i >= 16){
-      dot += simdDotProduct512<N,Q>(x+i,y+i);
-      i += ((N-i) & -16);
-   }
+   constexpr size_t n512 = W >= 512 ? N & ~size_t(15) : 0;
+   if constexpr (n512 > 0) dot += simdDotProduct512<n512,Q>(x,y);
+#else
+   constexpr size_t n512 = 0;
 #endif
 
 #if V_SIMD_256
-   if (N-i >= 8){
-      dot += simdDotProduct256<N,Q>(x+i,y+i);
-      i += ((N-i) & -8);
-   }
+   constexpr size_t n256 = W >= 256 ? (N - n512) & ~size_t(7) : 0;
+   if constexpr (n256 > 0) dot += simdDotProduct256<n256,Q>(x + n512, y + n512);
+#else
+   constexpr size_t n256 = 0;
 #endif
 
 #if V_SIMD_128
-   if (N-i >= 4){
-      dot += simdDotProduct128<N,Q>(x+i,y+i);
-      i += ((N-i) & -4);
+   constexpr size_t n128 = W >= 128 ? (N - n512 - n256) & ~size_t(3) : 0;
+   if constexpr (n128 > 0) dot += simdDotProduct128<n128,Q>(x + n512 + n256, y + n512 + n256);
+#else
+   constexpr size_t n128 = 0;
+#endif
+
+   constexpr size_t nDefault = (N - n512 - n256 - n128) & ~size_t(3);
+   if constexpr (nDefault > 0) dot += simdDotProductDefault<nDefault,Q>(x + n512 + n256 + n128, y + n512 + n256 + n128);
+
+   for (size_t i = n512 + n256 + n128 + nDefault; i < N; ++i) {
+      dot += y[i] * activation<Q>(x[i]);
+   }
+   return dot;
+}
+
+template<size_t N, bool Q> [[nodiscard]] float simdDotProduct(const float* RESTRICT x, const float* RESTRICT y) {
+   return simdDispatch([&]<int W>() { return simdDotProductW<N, Q, W>(x, y); });
+}
+
+template<size_t N, bool ADD, int W, typename T> FORCE_FINLINE void simdUpdateW(T* RESTRICT x, const T* RESTRICT y) {
+   if constexpr (std::is_same_v<T, int16_t>) {
+#ifdef V_SIMD_512_I16
+      if constexpr (W >= 512 && N % 32 == 0) { simdUpdateI16_512<N, ADD>(x, y); return; }
+#endif
+#ifdef V_SIMD_256
+      if constexpr (W >= 256 && N % 16 == 0) { simdUpdateI16_256<N, ADD>(x, y); return; }
+#endif
+   }
+   else if constexpr (std::is_same_v<T, float>) {
+#ifdef V_SIMD_512
+      if constexpr (W >= 512 && N % 16 == 0) { simdUpdateF32_512<N, ADD>(x, y); return; }
+#endif
+#ifdef V_SIMD_256
+      if constexpr (W >= 256 && N % 8 == 0) { simdUpdateF32_256<N, ADD>(x, y); return; }
+#endif
+   }
+#pragma omp simd
+   for (size_t i = 0; i < N; ++i) {
+      if constexpr (ADD) x[i] += y[i];
+      else               x[i] -= y[i];
+   }
+}
+
+// accumulator update x += y (ADD) or x -= y
+template<size_t N, bool ADD, typename T> FORCE_FINLINE void simdUpdate(T* RESTRICT x, const T* RESTRICT y) {
+   simdDispatch([&]<int W>() { simdUpdateW<N, ADD, W>(x, y); });
+}
+
+template<size_t N, int W, int NA, int NS, typename T>
+FORCE_FINLINE void simdMultiUpdateW(T* x, const T* src, const T* const* adds, const T* const* subs) {
+   if constexpr (std::is_same_v<T, int16_t>) {
+#ifdef V_SIMD_512_I16
+      if constexpr (W >= 512 && N % 32 == 0) { simdMultiUpdateI16_512<N, NA, NS>(x, src, adds, subs); return; }
+#endif
+#ifdef V_SIMD_256
+      if constexpr (W >= 256 && N % 16 == 0) { simdMultiUpdateI16_256<N, NA, NS>(x, src, adds, subs); return; }
+#endif
    }
+   else if constexpr (std::is_same_v<T, float>) {
+#ifdef V_SIMD_512
+      if constexpr (W >= 512 && N % 16 == 0) { simdMultiUpdateF32_512<N, NA, NS>(x, src, adds, subs); return; }
 #endif
+#ifdef V_SIMD_256
+      if constexpr (W >= 256 && N % 8 == 0) { simdMultiUpdateF32_256<N, NA, NS>(x, src, adds, subs); return; }
+#endif
+   }
+#pragma omp simd
+   for (size_t i = 0; i < N; ++i) {
+      T v = src[i];
+      for (int k = 0; k < NA; ++k) v += adds[k][i];
+      for (int k = 0; k < NS; ++k) v -= subs[k][i];
+      x[i] = v;
+   }
+}
+
+// fused accumulator update x = src + sum(adds) - sum(subs) in a single pass, x and src may alias
+// a move is always one add and one or two subs (capture), returns false for other cases
+template<size_t N, typename T>
+[[nodiscard]] FORCE_FINLINE bool simdMultiUpdate(T* x, const T* src, const T* const* adds, const int nAdds, const T* const* subs, const int nSubs) {
+   if (nAdds != 1 || (nSubs != 1 && nSubs != 2)) return false;
+   simdDispatch([&]<int W>() {
+      if (nSubs == 1) simdMultiUpdateW<N, W, 1, 1>(x, src, adds, subs);
+      else            simdMultiUpdateW<N, W, 1, 2>(x, src, adds, subs);
+   });
+   return true;
+}
+
+//----------------------------------
+// Integer kernels for inner layers
+// uint8 activations times int8 weights accumulated in int32
+// with |x| <= 127 and |w| <= 127, maddubs int16 intermediate sum cannot saturate
+//----------------------------------
+#if defined(V_SIMD_256)
+SIMD_TARGET_256 FORCE_FINLINE __m256i v_dpbusd_i32_256(const __m256i acc, const __m256i x, const __m256i y) {
+#if defined(__AVX512VNNI__) && defined(__AVX512VL__)
+   return _mm256_dpbusd_epi32(acc, x, y);
+#elif defined(__AVXVNNI__)
+   return _mm256_dpbusd_avx_epi32(acc, x, y);
+#else
+   return _mm256_add_epi32(acc, _mm256_madd_epi16(_mm256_maddubs_epi16(x, y), _mm256_set1_epi16(1)));
+#endif
+}
+
+SIMD_TARGET_256 FORCE_FINLINE int32_t v_sum_i32_256(const __m256i a) {
+   __m128i sum = _mm_add_epi32(_mm256_castsi256_si128(a), _mm256_extracti128_si256(a, 1));
+   sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0x4E));
+   sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0xB1));
+   return _mm_cvtsi128_si32(sum);
+}
 
-   if (N-i >= 4){
-      dot += simdDotProductDefault<N,Q>(x+i,y+i);
-      i += ((N-i) & -4);
+template<size_t N> [[nodiscard]] SIMD_TARGET_256 int32_t simdDotProductI8_256(const uint8_t* RESTRICT x, const int8_t* RESTRICT y) {
+   constexpr size_t vstep   = 32;
+   constexpr size_t unrollx = N & -vstep;
+   __m256i vsum0 = _mm256_setzero_si256();
+   for (size_t i = 0; i < unrollx; i += vstep) {
+      vsum0 = v_dpbusd_i32_256(vsum0, _mm256_loadu_si256((const __m256i*)(x + i)), _mm256_loadu_si256((const __m256i*)(y + i)));
    }
+   return v_sum_i32_256(vsum0);
+}
+#endif
 
-   while (i < N) {
-      dot += y[i] * activation<Q>(x[i]);
-      ++i;
+#if defined(__SSSE3__) || defined(WITH_CPU_DISPATCH)
+#define V_SIMD_128_I8 128
+SIMD_TARGET_128 FORCE_FINLINE int32_t v_sum_i32_128(__m128i a) {
+   a = _mm_add_epi32(a, _mm_shuffle_epi32(a, 0x4E));
+   a = _mm_add_epi32(a, _mm_shuffle_epi32(a, 0xB1));
+   return _mm_cvtsi128_si32(a);
+}
+
+template<size_t N> [[nodiscard]] SIMD_TARGET_128 int32_t simdDotProductI8_128(const uint8_t* RESTRICT x, const int8_t* RESTRICT y) {
+   constexpr size_t vstep   = 16;
+   constexpr size_t unrollx = N & -vstep;
+   const __m128i un = _mm_set1_epi16(1);
+   __m128i vsum0 = _mm_setzero_si128();
+   for (size_t i = 0; i < unrollx; i += vstep) {
+      const __m128i p = _mm_maddubs_epi16(_mm_loadu_si128((const __m128i*)(x + i)), _mm_loadu_si128((const __m128i*)(y + i)));
+      vsum0 = _mm_add_epi32(vsum0, _mm_madd_epi16(p, un));
    }
+   return v_sum_i32_128(vsum0);
+}
+#endif
+
+template<size_t N, int W> [[nodiscard]] FORCE_FINLINE int32_t simdDotProductI8W(const uint8_t* RESTRICT x, const int8_t* RESTRICT y) {
+   int32_t dot = 0;
+#if defined(V_SIMD_256)
+   constexpr size_t n256 = W >= 256 ? N & ~size_t(31) : 0;
+   if constexpr (n256 > 0) dot += simdDotProductI8_256<n256>(x, y);
+#else
+   constexpr size_t n256 = 0;
+#endif
+#if defined(V_SIMD_128_I8)
+   constexpr size_t n128 = W >= 128 ? (N - n256) & ~size_t(15) : 0;
+   if constexpr (n128 > 0) dot += simdDotProductI8_128<n128>(x + n256, y + n256);
+#else
+   constexpr size_t n128 = 0;
+#endif
+   for (size_t i = n256 + n128; i < N; ++i) dot += static_cast<int32_t>(x[i]) * y[i];
    return dot;
 }
 
+template<size_t N> [[nodiscard]] int32_t simdDotProductI8(const uint8_t* RESTRICT x, const int8_t* RESTRICT y) {
+   return simdDispatch([&]<int W>() { return simdDotProductI8W<N, W>(x, y); });
+}
+
 /*
 int main(int, char**){
    constexpr int n = 768;
@@ -17,6 +17,9 @@ struct StackVector {
 
    template<typename T2> 
    constexpr StackVector<T, dim, Q>& add_(const T2* other) {
+#ifdef USE_SIMD_INTRIN
+      if constexpr (std::is_same_v<T, T2> && (std::is_same_v<T, int16_t> || std::is_same_v<T, float>)) { simdUpdate<dim, true>(data, other); return *this; }
+#endif
 #pragma omp simd
       for (size_t i = 0; i < dim; ++i) { data[i] += other[i]; }
       return *this;
@@ -24,6 +27,9 @@ struct StackVector {
 
    template<typename T2> 
    constexpr StackVector<T, dim, Q>& sub_(const T2* other) {
+#ifdef USE_SIMD_INTRIN
+      if constexpr (std::is_same_v<T, T2> && (std::is_same_v<T, int16_t> || std::is_same_v<T, float>)) { simdUpdate<dim, false>(data, other); return *this; }
+#endif
 #pragma omp simd
       for (size_t i = 0; i < dim; ++i) { data[i] -= other[i]; }
       return *this;
@@ -40,6 +46,31 @@ struct StackVector {
    T dot_(const T* other) const { return simdDotProduct<dim,Q>(data, other); }
 #endif
 
+   // integer dot product for inner layers integer path (uint8 activations, int8 weights)
+   template<typename T2>
+   int32_t dotI8_(const T2* other) const {
+      static_assert(std::is_same_v<T, uint8_t> && std::is_same_v<T2, int8_t>);
+#ifdef USE_SIMD_INTRIN
+      return simdDotProductI8<dim>(data, other);
+#else
+      int32_t dot = 0;
+#pragma omp simd reduction(+:dot)
+      for (size_t i = 0; i < dim; ++i) { dot += static_cast<int32_t>(data[i]) * other[i]; }
+      return dot;
+#endif
+   }
+
+   // integer clipped ReLU, shift being the ratio between current scale and activation scale (rounding to nearest)
+   template<typename U, int shift, int maxValue>
+   [[nodiscard]] constexpr StackVector<U, dim, Q> activateInt() const {
+      static_assert(std::is_integral_v<T> && std::is_integral_v<U> && shift > 0);
+      constexpr int32_t half = 1 << (shift - 1);
+      StackVector<U, dim, Q> result;
+#pragma omp simd
+      for (size_t i = 0; i < dim; ++i) { result.data[i] = static_cast<U>(std::clamp((static_cast<int32_t>(data[i]) + half) >> shift, 0, maxValue)); }
+      return result; //RVO
+   }
+
    template<typename T2> 
    FORCE_FINLINE void from(const T2* other) {
 #pragma omp simd
@@ -257,7 +257,11 @@ void registerCOMOptions() { // options exposed to GUI
    _keys.emplace_back(k_int,   w_spin,  "UCI_Elo"                     , &DynamicConfig::strength                       , (int)500         , (int)2800);
    _keys.emplace_back(k_int,   w_spin,  "Hash"                        , &DynamicConfig::ttSizeMb                       , (unsigned int)1  , (unsigned int)256000                , &TT::initTable);
    _keys.emplace_back(k_int,   w_spin,  "PawnHash"                    , &DynamicConfig::ttPawnSizeMb                   , (unsigned int)1  , (unsigned int)256                   , &ThreadPool::initPawnTables);
+   _keys.emplace_back(k_bool,  w_check, "LargePages"                  , &DynamicConfig::largePages                     , false            , true                                , [](){TT::initTable(); ThreadPool::initPawnTables();});
+   _keys.emplace_back(k_string,w_combo, "NumaPolicy"                  , &DynamicConfig::numaPolicy                     , std::vector<std::string>{ "none", "interleave", "firstTouch"}           , [](){TT::initTable(); ThreadPool::initPawnTables();});
    _keys.emplace_back(k_int,   w_spin,  "Threads"                     , &DynamicConfig::threads                        , (unsigned int)1  , (unsigned int)(MAX_THREADS-1)       , std::bind(&ThreadPool::setup, &ThreadPool::instance()));
+   _keys.emplace_back(k_string,w_combo, "ThreadBinding"               , &DynamicConfig::threadBinding                  , std::vector<std::string>{ "none", "cores", "nodes"}                     , std::bind(&ThreadPool::setup, &ThreadPool::instance()));
+   _keys.emplace_back(k_string,w_combo, "SMPPolicy"                   , &DynamicConfig::smpPolicy                      , std::vector<std::string>{ "static", "depthCount"});
    _keys.emplace_back(k_bool,  w_check, "UCI_Chess960"                , &DynamicConfig::FRC                            , false            , true);
    _keys.emplace_back(k_bool,  w_check, "Ponder"                      , &DynamicConfig::UCIPonder                      , false            , true);
    _keys.emplace_back(k_bool,  w_check, "MateFinder"                  , &DynamicConfig::mateFinder                     , false            , true);
@@ -425,10 +429,14 @@ void initOptions(int argc, char** argv) {
    GETOPT(debugFile, std::string)
    GETOPT(ttSizeMb, unsigned int)
    GETOPT(ttPawnSizeMb, unsigned int)
+   GETOPT(largePages, bool)
+   GETOPT(numaPolicy, std::string)
    GETOPT(contempt, ScoreType)
    GETOPT(FRC, bool)
    GETOPT(DFRC, bool)
    GETOPT(threads, unsigned int)
+   GETOPT(smpPolicy, std::string)
+   GETOPT(threadBinding, std::string)
    GETOPT(mateFinder, bool)
    GETOPT(fullXboardOutput, bool)
    GETOPT(level, unsigned int)
@@ -443,6 +451,7 @@ void initOptions(int argc, char** argv) {
    GETOPT(withWDL, bool)
    GETOPT(bongCloud, bool)
    GETOPT(anarchy, bool)
+   GETOPT(perftDetails, bool)
    Options::getOption<uint64_t>(TimeMan::maxNodes, "maxNodes");
 
 #ifdef WITH_SYZYGY
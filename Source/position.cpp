@@ -267,12 +267,6 @@ void RootInformation::initCaslingPermHashTable() {
    }
 }
 
-Position::~Position() {
-   //I do not delete the root pointer, only a RootPosition can do that
-}
-
-Position::Position() {}
-
 /*
 #include <immintrin.h>
 
@@ -49,10 +49,12 @@ struct RootInformation {
  *  Contains also some usefull accessor
  *
  * Minic is a copy/make engine, so that this structure is copied a lot !
+ * (make/unmake is also available, see ScopedMove)
+ * No vtable : Position is trivially copyable, and never deleted through a base pointer.
+ * The root pointer is not deleted here, only a RootPosition can do that.
  */
 struct alignas(32) Position {
-   Position();
-   virtual ~Position();
+   Position() = default;
 
    array1d<Piece, NbSquare> _b {{P_none}}; // works because P_none is in fact 0
    array1d<BitBoard, 6>     _allB {{emptyBitBoard}}; // works because emptyBitBoard is in fact 0
@@ -209,10 +211,42 @@ struct alignas(32) Position {
       const bool   isCapNoEP = false;
    };
 
+   // state that cannot be recomputed from MoveInfo when taking a move back (see unmakeMove)
+   struct UndoInfo {
+      explicit UndoInfo(const Position& p):
+          mat(p.mat),
 #ifdef WITH_NNUE
-   void associateEvaluator(NNUEEvaluator& evaluator, bool dirty = true) { 
+          associatedEvaluator(p.associatedEvaluator),
+#endif
+          h(p.h),
+          ph(p.ph),
+          lastMove(p.lastMove),
+          moves(p.moves),
+          halfmoves(p.halfmoves),
+          king(p.king),
+          ep(p.ep),
+          fifty(p.fifty),
+          castling(p.castling),
+          c(p.c) {}
+      const Material        mat;
+#ifdef WITH_NNUE
+      NNUEEvaluator* const  associatedEvaluator;
+#endif
+      const Hash            h;
+      const Hash            ph;
+      const MiniMove        lastMove;
+      const uint16_t        moves;
+      const uint16_t        halfmoves;
+      const colored<Square> king;
+      const Square          ep;
+      const uint8_t         fifty;
+      const CastlingRights  castling;
+      const Color           c;
+   };
+
+#ifdef WITH_NNUE
+   void associateEvaluator(NNUEEvaluator& evaluator) { 
       associatedEvaluator = &evaluator; 
-      evaluator.dirty = dirty;
    }
 
    void dissociateEvaluator() { 
@@ -276,12 +310,36 @@ struct alignas(32) Position {
       });
    }
 
+   // refresh c perspective using the cached accumulator for the current king square,
+   // only pieces that differ from the cached position are added or removed
+   template<Color c> void refreshNNUEIndices_(NNUEEvaluator& nnueEvaluator, NNUEFinnyEntry& entry) const {
+      auto & acc = entry.active;
+      const auto & weights = *nnueEvaluator.template us<c>().weights_;
+      if (!entry.valid) {
+         acc.from(weights.b);
+         for (auto & bbs : entry.pieces) bbs.fill(emptyBitBoard);
+         entry.valid = true;
+      }
+      for (Piece pt = P_wp; pt <= P_wk; ++pt) {
+         const BitBoard usBB   = pieces_const(c, pt);
+         const BitBoard themBB = pieces_const(~c, pt);
+         BitBoard & usCached   = entry.pieces[0][pt - 1];
+         BitBoard & themCached = entry.pieces[1][pt - 1];
+         BB::applyOn(usBB & ~usCached, [&](const Square & k) { weights.insertIdx(NNUEIndiceUs(king[c], k, pt), acc); });
+         BB::applyOn(usCached & ~usBB, [&](const Square & k) { weights.eraseIdx(NNUEIndiceUs(king[c], k, pt), acc); });
+         BB::applyOn(themBB & ~themCached, [&](const Square & k) { weights.insertIdx(NNUEIndiceThem(king[c], k, pt), acc); });
+         BB::applyOn(themCached & ~themBB, [&](const Square & k) { weights.eraseIdx(NNUEIndiceThem(king[c], k, pt), acc); });
+         usCached   = usBB;
+         themCached = themBB;
+      }
+      nnueEvaluator.template us<c>().refreshFrom(acc);
+   }
+
    void resetNNUEEvaluator(NNUEEvaluator& nnueEvaluator) const {
       START_TIMER
       nnueEvaluator.clear();
       resetNNUEIndices_<Co_White>(nnueEvaluator);
       resetNNUEIndices_<Co_Black>(nnueEvaluator);
-      nnueEvaluator.dirty = false;
       STOP_AND_SUM_TIMER(ResetNNUE)
    }
 
@@ -292,13 +350,23 @@ struct alignas(32) Position {
          resetNNUEIndices_<Co_White>(nnueEvaluator);
       else
          resetNNUEIndices_<Co_Black>(nnueEvaluator);
-      nnueEvaluator.dirty = false;
+      STOP_AND_SUM_TIMER(ResetNNUE)
+   }
+
+   void resetNNUEEvaluator(NNUEEvaluator& nnueEvaluator, Color color, NNUEFinnyTable& finny) const {
+      START_TIMER
+      if (color == Co_White)
+         refreshNNUEIndices_<Co_White>(nnueEvaluator, finny.entries[Co_White][king[Co_White]]);
+      else
+         refreshNNUEIndices_<Co_Black>(nnueEvaluator, finny.entries[Co_Black][king[Co_Black]]);
       STOP_AND_SUM_TIMER(ResetNNUE)
    }
 
 #endif
 };
 
+static_assert(std::is_trivially_copyable_v<Position>, "Position is copied a lot, keep it a plain struct");
+
 /*!
  * RootPosition only specific responsability is to
  * allocate and delete root pointer
@@ -320,61 +388,58 @@ struct RootPosition : public Position {
    // Root position cannot be copied
    RootPosition & operator=(const RootPosition &) = delete;
 
-   ~RootPosition() override {
+   ~RootPosition() {
       delete root;
    }
 
 };
 
 #ifdef WITH_NNUE
-template<Color c> void updateNNUEEvaluator(NNUEEvaluator& nnueEvaluator, const Position::MoveInfo& moveInfo) {
-   START_TIMER
+// record the feature changes of a move (applied later, see FeatureTransformer::applyDelta)
+template<Color c> void setNNUEDelta(NNUEEvaluator& nnueEvaluator, const Position::MoveInfo& moveInfo) {
    const Piece fromType = Abs(moveInfo.fromP);
    const Piece toType = Abs(moveInfo.toP);
-   nnueEvaluator.template us<c>().erase(NNUEIndiceUs(moveInfo.king[c], moveInfo.from, fromType));
-   nnueEvaluator.template them<c>().erase(NNUEIndiceThem(moveInfo.king[~c], moveInfo.from, fromType));
+   nnueEvaluator.template us<c>().pushRemoved(NNUEIndiceUs(moveInfo.king[c], moveInfo.from, fromType));
+   nnueEvaluator.template them<c>().pushRemoved(NNUEIndiceThem(moveInfo.king[~c], moveInfo.from, fromType));
    if (isPromotion(moveInfo.type)) {
       const Piece promPieceType = promShift(moveInfo.type);
-      nnueEvaluator.template us<c>().insert(NNUEIndiceUs(moveInfo.king[c], moveInfo.to, promPieceType));
-      nnueEvaluator.template them<c>().insert(NNUEIndiceThem(moveInfo.king[~c], moveInfo.to, promPieceType));
+      nnueEvaluator.template us<c>().pushAdded(NNUEIndiceUs(moveInfo.king[c], moveInfo.to, promPieceType));
+      nnueEvaluator.template them<c>().pushAdded(NNUEIndiceThem(moveInfo.king[~c], moveInfo.to, promPieceType));
    }
    else {
-      nnueEvaluator.template us<c>().insert(NNUEIndiceUs(moveInfo.king[c], moveInfo.to, fromType));
-      nnueEvaluator.template them<c>().insert(NNUEIndiceThem(moveInfo.king[~c], moveInfo.to, fromType));
+      nnueEvaluator.template us<c>().pushAdded(NNUEIndiceUs(moveInfo.king[c], moveInfo.to, fromType));
+      nnueEvaluator.template them<c>().pushAdded(NNUEIndiceThem(moveInfo.king[~c], moveInfo.to, fromType));
    }
    if (moveInfo.type == T_ep) {
       const Square epSq = moveInfo.ep + (c == Co_White ? -8 : +8);
-      nnueEvaluator.template us<c>().erase(NNUEIndiceThem(moveInfo.king[c], epSq, P_wp));
-      nnueEvaluator.template them<c>().erase(NNUEIndiceUs(moveInfo.king[~c], epSq, P_wp));
+      nnueEvaluator.template us<c>().pushRemoved(NNUEIndiceThem(moveInfo.king[c], epSq, P_wp));
+      nnueEvaluator.template them<c>().pushRemoved(NNUEIndiceUs(moveInfo.king[~c], epSq, P_wp));
    }
    else if (toType != P_none) {
-      nnueEvaluator.template us<c>().erase(NNUEIndiceThem(moveInfo.king[c], moveInfo.to, toType));
-      nnueEvaluator.template them<c>().erase(NNUEIndiceUs(moveInfo.king[~c], moveInfo.to, toType));
+      nnueEvaluator.template us<c>().pushRemoved(NNUEIndiceThem(moveInfo.king[c], moveInfo.to, toType));
+      nnueEvaluator.template them<c>().pushRemoved(NNUEIndiceUs(moveInfo.king[~c], moveInfo.to, toType));
    }
-   nnueEvaluator.dirty = false;
-   STOP_AND_SUM_TIMER(UpdateNNUE)
 }
 
-template<Color c> void updateNNUEEvaluatorThemOnly(NNUEEvaluator& nnueEvaluator, const Position::MoveInfo& moveInfo) {
-   START_TIMER
+// king move (not castling), own perspective needs a reset, only the opponent one can be updated
+template<Color c> void setNNUEDeltaThemOnly(NNUEEvaluator& nnueEvaluator, const Position::MoveInfo& moveInfo) {
    const Piece fromType = Abs(moveInfo.fromP);
    const Piece toType = Abs(moveInfo.toP);
-   nnueEvaluator.template them<c>().erase(NNUEIndiceThem(moveInfo.king[~c], moveInfo.from, fromType));
+   nnueEvaluator.template us<c>().needRefresh_ = true;
+   nnueEvaluator.template them<c>().pushRemoved(NNUEIndiceThem(moveInfo.king[~c], moveInfo.from, fromType));
    if (isPromotion(moveInfo.type)) {
       const Piece promPieceType = promShift(moveInfo.type);
-      nnueEvaluator.template them<c>().insert(NNUEIndiceThem(moveInfo.king[~c], moveInfo.to, promPieceType));
+      nnueEvaluator.template them<c>().pushAdded(NNUEIndiceThem(moveInfo.king[~c], moveInfo.to, promPieceType));
    }
    else {
-      nnueEvaluator.template them<c>().insert(NNUEIndiceThem(moveInfo.king[~c], moveInfo.to, fromType));
+      nnueEvaluator.template them<c>().pushAdded(NNUEIndiceThem(moveInfo.king[~c], moveInfo.to, fromType));
    }
    if (moveInfo.type == T_ep) {
       const Square epSq = moveInfo.ep + (c == Co_White ? -8 : +8);
-      nnueEvaluator.template them<c>().erase(NNUEIndiceUs(moveInfo.king[~c], epSq, P_wp));
+      nnueEvaluator.template them<c>().pushRemoved(NNUEIndiceUs(moveInfo.king[~c], epSq, P_wp));
    }
    else if (toType != P_none) {
-      nnueEvaluator.template them<c>().erase(NNUEIndiceUs(moveInfo.king[~c], moveInfo.to, toType));
+      nnueEvaluator.template them<c>().pushRemoved(NNUEIndiceUs(moveInfo.king[~c], moveInfo.to, toType));
    }
-   nnueEvaluator.dirty = false;
-   STOP_AND_SUM_TIMER(UpdateNNUE)
 }
 #endif
\ No newline at end of file
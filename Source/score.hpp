@@ -1,5 +1,6 @@
 #pragma once
 
+#include "attack.hpp"
 #include "definition.hpp"
 #include "logging.hpp"
 
@@ -236,6 +237,7 @@ struct EvalData {
    colored<bool>      haveThreats = {false, false};
    colored<bool>      goodThreats = {false, false};
    bool evalDone = false; // will tell if phase, danger and mobility are filleds or not
+   BBTools::AttackMap attacks; // filled by evaluation (or lazily by search), see attacks.done
 };
 
 // used for easy move detection
@@ -1,5 +1,6 @@
 #include "searcher.hpp"
 
+#include "allocator.hpp"
 #include "com.hpp"
 #include "dynamicConfig.hpp"
 #include "logging.hpp"
@@ -68,10 +69,10 @@ void Searcher::getCMHPtr(const unsigned int ply, CMHPtrArray& cmhPtr) {
    cmhPtr.fill(nullptr);
    for (unsigned int k = 0; k < MAX_CMH_PLY; ++k) {
       assert(static_cast<int>(ply) - static_cast<int>(2*k) < MAX_PLY && static_cast<int>(ply) - static_cast<int>(2*k) >= 0);
-      if (ply > 2*k && isValidMove(stack[ply - 2*k].p.lastMove)) {
-         const Position & pRef = stack[ply - 2*k].p;
-         const Square to = correctedMove2ToKingDest(pRef.lastMove);
-         const int ptIdx = isEnPassant(pRef.lastMove) ? PieceIdx(P_wp) : PieceIdx(pRef.board_const(to));
+      if (ply > 2*k && isValidMove(stack[ply - 2*k].lastMove)) {
+         const StackData & dRef = stack[ply - 2*k];
+         const Square to = correctedMove2ToKingDest(dRef.lastMove);
+         const int ptIdx = HistoryT::cmhPrevIdx(dRef.movedPiece);
          cmhPtr[k] = &historyT.counter_history[ptIdx][to];
       }
    }
@@ -98,7 +99,7 @@ bool Searcher::isMoobing(uint16_t halfmove){
 ScoreType Searcher::getCMHScore(const Position& p, const Square from, const Square to, const CMHPtrArray& cmhPtr) const {
    ScoreType ret = 0;
    for (int i = 0; i < MAX_CMH_PLY; i++) {
-      if (cmhPtr[i]) { ret += (*cmhPtr[i])[PieceIdx(p.board_const(from)) * NbSquare + to]; }
+      if (cmhPtr[i]) { ret += (*cmhPtr[i])[HistoryT::cmhIdx(p.board_const(from), to)]; }
    }
    return ret/MAX_CMH_PLY;
 }
@@ -106,7 +107,7 @@ ScoreType Searcher::getCMHScore(const Position& p, const Square from, const Squa
 bool Searcher::isCMHGood(const Position& p, const Square from, const Square to, const CMHPtrArray& cmhPtr, const ScoreType threshold) const {
    for (int i = 0; i < MAX_CMH_PLY; i++) {
       if (cmhPtr[i]) {
-         const auto cmhScore = (*cmhPtr[i])[PieceIdx(p.board_const(from)) * NbSquare + to];
+         const auto cmhScore = (*cmhPtr[i])[HistoryT::cmhIdx(p.board_const(from), to)];
          if (cmhScore >= threshold){
                /*
                std::cout << ToString(p) << std::endl;
@@ -125,7 +126,7 @@ bool Searcher::isCMHBad(const Position& p, const Square from, const Square to, c
    int nbBad = 0;
    for (int i = 0; i < MAX_CMH_PLY; i++) {
       if (cmhPtr[i]) {
-         if ((*cmhPtr[i])[PieceIdx(p.board_const(from)) * NbSquare + to] < threshold) ++nbBad;
+         if ((*cmhPtr[i])[HistoryT::cmhIdx(p.board_const(from), to)] < threshold) ++nbBad;
       }
    }
    return nbBad == MAX_CMH_PLY;
@@ -138,10 +139,14 @@ ScoreType Searcher::drawScore(const Position& p, DepthType height) const {
       if (p.c == Co_White) return matedScore(height);
       else return matingScore(height-1);
    }
-   return static_cast<ScoreType>(-1 + 2 * ((stats.counters[Stats::sid_nodes] + stats.counters[Stats::sid_qnodes]) % 2));
+   return static_cast<ScoreType>(-1 + 2 * (stats.nodes() % 2));
 }
 
 void Searcher::idleLoop() {
+   // pin this thread (see ThreadBinding option), the Searcher object is already on its node (see operator new)
+   if (id() < MAX_THREADS && Allocator::threadBinding() != Allocator::TB_none) {
+      Allocator::bindSearchThread(id(), DynamicConfig::threads);
+   }
    while (true) {
       std::unique_lock<std::mutex> lock(_mutex);
       Logging::LogIt(Logging::logInfo) << "begin of idleloop " << id();
@@ -175,7 +180,7 @@ void Searcher::wait() {
 
 // multi-threaded search (blocking call)
 void Searcher::searchLauncher() {
-   Logging::LogIt(Logging::logInfo) << "Search launched for thread " << id();
+   Logging::LogIt(Logging::logInfo) << "Search launched for thread " << id() << " (" << ThreadPool::instance().usSinceStart() << "us after search request)";
    // starts other threads first but they are locked for now ...
    if (isMainThread()) { ThreadPool::instance().startOthers(); }
    // so here searchDriver() will update the thread _data structure
@@ -191,6 +196,20 @@ Searcher::Searcher(size_t n): _index(n), _exit(false), _searching(true), _stdThr
    wait(); // wait for idleLoop to start in the _stdThread object
 }
 
+static_assert(alignof(Searcher) <= 64, "Searcher allocation alignment");
+
+void* Searcher::operator new(size_t size) { return std_aligned_alloc(64, size); }
+
+void* Searcher::operator new(size_t size, size_t threadId, size_t nbThreads) {
+   if (threadId < MAX_THREADS && Allocator::threadBinding() != Allocator::TB_none)
+      return Allocator::allocOnNode(size, Allocator::nodeOfThread(threadId, nbThreads));
+   return std_aligned_alloc(64, size);
+}
+
+void Searcher::operator delete(void* ptr) { std_aligned_free(ptr); }
+
+void Searcher::operator delete(void* ptr, size_t, size_t) { std_aligned_free(ptr); }
+
 Searcher::~Searcher() {
    _exit = true;
    startThread();
@@ -213,7 +232,7 @@ const SearchData& Searcher::getSearchData() const { return _data.datas; }
 bool Searcher::searching() const { return _searching; }
 
 namespace{
-    std::unique_ptr<Searcher::PawnEntry[]> tablePawn = nullptr;
+    std::unique_ptr<Searcher::PawnEntry[], Allocator::DeleteAligned<Searcher::PawnEntry>> tablePawn = nullptr;
     uint64_t ttSizePawn = 0;
 }
 
@@ -222,8 +241,10 @@ void Searcher::initPawnTable() {
    Logging::LogIt(Logging::logInfo) << "PawnEntry size " << sizeof(PawnEntry);
    ttSizePawn = powerFloor((SIZE_MULTIPLIER * DynamicConfig::ttPawnSizeMb) / sizeof(PawnEntry));
    assert(BB::countBit(ttSizePawn) == 1); // a power of 2
-   tablePawn.reset(new PawnEntry[ttSizePawn]);
-   Logging::LogIt(Logging::logInfo) << "Size of Pawn TT " << ttSizePawn * sizeof(PawnEntry) / 1024 << "Kb";
+   tablePawn.reset(static_cast<PawnEntry*>(Allocator::alloc(ttSizePawn * sizeof(PawnEntry))));
+   // this table is shared by all threads, it keeps the NumaPolicy placement of Allocator::alloc
+   Allocator::clear(tablePawn.get(), ttSizePawn, 1, PawnEntry());
+   Logging::LogIt(Logging::logInfo) << "Size of Pawn TT " << ttSizePawn * sizeof(PawnEntry) / 1024 << "Kb (" << Allocator::mode() << ")";
 }
 
 void Searcher::clearPawnTT() {
@@ -240,7 +261,7 @@ void Searcher::clearGame() {
 
    // clear stack data
    for (auto & d : stack){
-      d = {Position(), nullHash, 0, INVALIDMINIMOVE};
+      d = StackData();
    }
 }
 
@@ -279,6 +300,11 @@ void Searcher::prefetchPawn(Hash h) {
 
 std::atomic<bool> Searcher::startLock;
 
+void Searcher::releaseOthers() {
+   startLock.store(false);
+   startLock.notify_all();
+}
+
 Searcher& Searcher::getCoSearcher(size_t id) {
    static std::map<size_t, std::unique_ptr<Searcher>> coSearchers;
    // init new co-searcher if not already present
@@ -18,12 +18,31 @@
 struct Searcher {
    bool stopFlag = true;
 
+   // compact per ply record (repetition, boom/moob, null move and CMH only need that)
    struct StackData {
-      Position  p;
-      Hash      h      = nullHash;
+      Hash      h          = nullHash;
       //EvalData  data;
-      ScoreType eval   = 0;
-      MiniMove  threat = INVALIDMINIMOVE;
+      ScoreType eval       = 0;
+      MiniMove  threat     = INVALIDMINIMOVE;
+      MiniMove  lastMove   = INVALIDMINIMOVE; // move that led to this position
+      Piece     movedPiece = P_none;          // piece on lastMove destination (king for castling)
+#ifdef DEBUG_FIFTY_COLLISION
+      Position  p;
+#endif
+
+      FORCE_FINLINE void set(const Position& pos, const Hash hash) {
+         h          = hash;
+         lastMove   = pos.lastMove;
+         movedPiece = isValidMove(pos.lastMove) ? pos.board_const(correctedMove2ToKingDest(pos.lastMove)) : P_none;
+#ifdef DEBUG_FIFTY_COLLISION
+         p = pos;
+#endif
+      }
+
+      // capture or pawn move
+      [[nodiscard]] FORCE_FINLINE bool irreversible() const {
+         return isValidMove(lastMove) && (isCapture(lastMove) || Abs(movedPiece) == P_wp);
+      }
    };
 
    struct PVSData{
@@ -99,6 +118,20 @@ struct Searcher {
    TimeType getCurrentMoveMs()const; // use this (and not the variable) to take emergency time into account !
 
    array1d<StackData, MAX_PLY> stack;
+
+   // game history hashes (positions before root, indexed by halfmove), built once per search by initGameHistory
+   // together with the stack, repetition detection is a bounded scan not going further than the last irreversible move
+   array1d<Hash, MAX_PLY> gameHashes;
+   uint16_t rootHalfmoves = 0;
+   uint16_t historyBegin  = 0; // first halfmove available in gameHashes
+   void initGameHistory(const Position& p);
+
+#ifdef WITH_NNUE
+   // lazy NNUE evaluators indexed by height, see applyMoveNNUELazyUpdate
+   array1d<NNUEEvaluator, MAX_DEPTH + 1> nnueStack;
+   // accumulator cache for king moves refresh
+   NNUEFinnyTable nnueFinny;
+#endif
    [[nodiscard]] bool isBooming(uint16_t halfmove); // from stack
    [[nodiscard]] bool isMoobing(uint16_t halfmove); // from stack
 
@@ -114,6 +147,28 @@ struct Searcher {
       std::ranges::copy(childPV, std::back_inserter(pv));
    }
 
+   // triangular PV table used by pvs, pvTable[h] holds the pvLength[h] moves PV from height h
+   // each pvs call clears its own line, a parent just prepends its move to the child line
+   array2d<Move, MAX_DEPTH + 1, MAX_DEPTH + 1> pvTable;
+   array1d<int, MAX_DEPTH + 2> pvLength {};
+
+   FORCE_FINLINE void clearPV(const DepthType height) { pvLength[height] = 0; }
+
+   FORCE_FINLINE void updatePV(const DepthType height, const Move& m) {
+      stats.incr(Stats::sid_PVupdate);
+      assert(height + 1 <= MAX_DEPTH);
+      const int childLength = std::min(pvLength[height + 1], MAX_DEPTH - height);
+      pvTable[height][0] = m;
+      std::copy_n(pvTable[height + 1].begin(), childLength, pvTable[height].begin() + 1);
+      pvLength[height] = childLength + 1;
+   }
+
+   [[nodiscard]] PVList getPVFromTable(const DepthType height = 0) const {
+      PVList pv;
+      for (int k = 0; k < pvLength[height]; ++k) pv.push_back(pvTable[height][k]);
+      return pv;
+   }
+
    void displayStats() const {
       for (size_t k = 0; k < Stats::sid_maxid; ++k) {
          Logging::LogIt(Logging::logInfo) << Stats::Names[k] << " " << stats.counters[(Stats::StatId)k];
@@ -164,7 +219,6 @@ struct Searcher {
                  const Position&              p,
                  DepthType                    depth,
                  DepthType                    height,
-                 PVList&                      pv,
                  DepthType&                   seldepth,
                  DepthType                    extensions,
                  bool                         isInCheck,
@@ -189,12 +243,15 @@ struct Searcher {
                                             DepthType&      seldepth,
                                             PVList*         pv = nullptr);
 
-   [[nodiscard]] static bool SEE_GE(const Position& p, const Move& m, ScoreType threshold);
+   [[nodiscard]] static bool SEE_GE(const Position& p, const Move& m, ScoreType threshold, const BBTools::AttackMap* attacks = nullptr);
 
-   [[nodiscard]] static ScoreType SEE(const Position& p, const Move& m);
+   [[nodiscard]] static ScoreType SEE(const Position& p, const Move& m, const BBTools::AttackMap* attacks = nullptr);
 
    void searchDriver(bool postMove = true);
 
+   // Lazy SMP best thread selection by voting, at the end of main thread search
+   [[nodiscard]] size_t pickBestThread();
+
    template<bool isPv = true>
    [[nodiscard]] std::optional<ScoreType> interiorNodeRecognizer(const Position& p, DepthType height) const;
 
@@ -223,6 +280,11 @@ struct Searcher {
 
    explicit Searcher(size_t n);
    ~Searcher();
+   // a search thread Searcher (and its history tables) is allocated on the NUMA node of its thread (see ThreadBinding)
+   [[nodiscard]] static void* operator new(size_t size);
+   [[nodiscard]] static void* operator new(size_t size, size_t threadId, size_t nbThreads);
+   static void operator delete(void* ptr);
+   static void operator delete(void* ptr, size_t threadId, size_t nbThreads);
    // non copyable
    Searcher(const Searcher&) = delete;
    Searcher(const Searcher&&) = delete;
@@ -235,7 +297,9 @@ struct Searcher {
    [[nodiscard]] const SearchData& getSearchData() const;
    [[nodiscard]] SearchData&       getSearchData();
 
+   // helper threads wait (passively) on this until main thread has done the first depth
    static std::atomic<bool> startLock;
+   static void releaseOthers();
 
    std::chrono::time_point<Clock> startTime;
 
@@ -1,7 +1,23 @@
+#include "attack.hpp"
 #include "com.hpp"
+#include "hash.hpp"
 #include "position.hpp"
 #include "searcher.hpp"
 
+void Searcher::initGameHistory(const Position& p) {
+   rootHalfmoves = p.halfmoves;
+   historyBegin  = p.halfmoves;
+   // no need to go further than last irreversible move
+   const int end = std::max(0, p.halfmoves - p.fifty);
+   const COM::GameInfo & gameInfo = COM::GetGameInfo();
+   for (int k = p.halfmoves - 1; k >= end; --k) {
+      const std::optional<Hash> curh = gameInfo.getHash(static_cast<uint16_t>(k));
+      if (!curh.has_value()) break;
+      gameHashes[k] = curh.value();
+      historyBegin  = static_cast<uint16_t>(k);
+   }
+}
+
 bool Searcher::isRep(const Position& p, bool isPV) const {
    // handles chess variants
    const int limit = isPV ? 2 : 1;
@@ -9,12 +25,9 @@ bool Searcher::isRep(const Position& p, bool isPV) const {
    int count = 0;
    const Hash h = computeHash(p);
    int k = p.halfmoves - 2;
-   bool irreversible = false;
-   //std::cout << "***************** " << h << " " << GetFEN(p) << std::endl;
-   // look in stack first
-   for ( ; k >= 0; k-=2) {
-      //std::cout << "stack " << stack[k].h << " " << count << " " << ToString(stack[k].p.lastMove) << " " << GetFEN(stack[k].p) << std::endl;
-      if (stack[k].h == nullHash) break; // no more "history" in stack (will look at game state later)
+   // look in stack first (current line from root)
+   // p.fifty cannot be used as a bound here as null moves are not counted in it
+   for ( ; k >= rootHalfmoves; k -= 2) {
       if (stack[k].h == h){
          ++count;
 #ifdef DEBUG_FIFTY_COLLISION
@@ -24,45 +37,15 @@ bool Searcher::isRep(const Position& p, bool isPV) const {
 #endif
          if (count >= limit) return true;
       }
-      // irreversible moves ?
-      if (k > 0 && isValidMove(stack[k-1].p.lastMove) && 
-          (isCapture(stack[k-1].p.lastMove) || PieceTools::getPieceType(stack[k-1].p, Move2To(stack[k-1].p.lastMove)) == P_wp)){
-            irreversible=true;
-            break;
-      }       
-      if (isValidMove(stack[k].p.lastMove) && 
-          (isCapture(stack[k].p.lastMove) || PieceTools::getPieceType(stack[k].p, Move2To(stack[k].p.lastMove)) == P_wp)){
-            irreversible=true;
-            break;
-      }
+      // irreversible moves ? (below root this is already handled by historyBegin)
+      if ((k - 1 >= rootHalfmoves && stack[k-1].irreversible()) || stack[k].irreversible()) return false;
    }
-   // then double check in game history
-   while(!irreversible && k>=0){
-      const std::optional<Hash> curh = COM::GetGameInfo().getHash(k);
-      if (!curh.has_value()) break;
-      //std::cout << "history " << curh.value() << " " << count << " " << ToString(COM::GetGameInfo().getMove(k).value()) << " " << GetFEN(COM::GetGameInfo().getPosition(k).value()) << std::endl;
-      if (curh.value() == h){
+   // then in game history (already bounded to last irreversible move)
+   for ( ; k >= historyBegin; k -= 2) {
+      if (gameHashes[k] == h){
          ++count;
          if (count >= limit) return true;
       }
-      // irreversible moves ?
-      if (k>0){
-         const auto m = COM::GetGameInfo().getMove(k-1);
-         const auto pp = COM::GetGameInfo().getPosition(k-1);
-         if ( m.has_value() &&
-            (isCapture(m.value()) || PieceTools::getPieceType(pp.value(), Move2To(m.value())) == P_wp)){
-               irreversible=true;
-               break;
-         }
-      }
-      const auto m = COM::GetGameInfo().getMove(k);
-      const auto pp = COM::GetGameInfo().getPosition(k);
-      if ( m.has_value() &&
-          (isCapture(m.value()) || PieceTools::getPieceType(pp.value(), Move2To(m.value())) == P_wp)){
-            irreversible=true;
-            break;
-      }
-      k-=2;
    }
    return false;
 }
@@ -13,6 +13,34 @@ namespace {
 constexpr unsigned int threadSkipSize = 20;
 constexpr array1d<int,threadSkipSize> skipSize  = {1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 3, 3, 4, 4, 4, 4, 4, 4, 4, 4};
 constexpr array1d<int,threadSkipSize> skipPhase = {0, 1, 0, 1, 2, 3, 0, 1, 2, 3, 4, 5, 0, 1, 2, 3, 4, 5, 6, 7};
+
+// number of threads currently searching each depth (used by the "depthCount" SMP policy)
+array1d<std::atomic<int>, MAX_DEPTH + 1> searchingThreads {};
+
+// registers current thread at a given depth for the scope of an iterative deepening iteration
+struct DepthRegistration {
+   explicit DepthRegistration(DepthType d, bool active): depth(d), registered(active) {
+      if (registered) searchingThreads[depth].fetch_add(1, std::memory_order_relaxed);
+   }
+   ~DepthRegistration() {
+      if (registered) searchingThreads[depth].fetch_sub(1, std::memory_order_relaxed);
+   }
+   DepthRegistration(const DepthRegistration&) = delete;
+   DepthRegistration& operator=(const DepthRegistration&) = delete;
+   const DepthType depth;
+   const bool registered;
+};
+
+// shall an helper thread skip this depth ?
+[[nodiscard]] bool skipDepth(const size_t id, const DepthType depth, const bool depthCountPolicy) {
+   // stockfish like static blocks
+   if (!depthCountPolicy) {
+      const auto i = (id - 1) % threadSkipSize;
+      return ((depth + skipPhase[i]) / skipSize[i]) % 2;
+   }
+   // a depth already searched by at least half of the threads is skipped
+   return 2 * static_cast<size_t>(searchingThreads[depth].load(std::memory_order_relaxed)) >= ThreadPool::instance().size();
+}
 } // namespace
 
 // Output following chosen protocol
@@ -28,7 +56,7 @@ void Searcher::displayGUI(DepthType          depth,
    getSearchData().times[depth] = ms;
    if (subSearch) return; // no need to display stuff for subsearch
    std::stringstream str;
-   const Counter nodeCount = ThreadPool::instance().counter(Stats::sid_nodes) + ThreadPool::instance().counter(Stats::sid_qnodes);
+   const Counter nodeCount = ThreadPool::instance().nodeCount();
    if (Logging::ct == Logging::CT_xboard) {
       str << static_cast<int>(depth) << " "
           << bestScore << " "
@@ -62,6 +90,52 @@ void Searcher::displayGUI(DepthType          depth,
    Logging::LogIt(Logging::logGUI) << str.str();
 }
 
+size_t Searcher::pickBestThread() {
+   // each thread votes for its best move, with a weight growing with depth and score (stockfish like)
+   struct Result {
+      size_t    id;
+      DepthType depth;
+      ScoreType score;
+      MiniMove  m;
+   };
+   std::vector<Result> results;
+   results.reserve(ThreadPool::instance().size());
+   for (const auto& s : ThreadPool::instance()) {
+      std::unique_lock<std::mutex> lock(s->_mutexPV);
+      const ThreadData& d = s->getData();
+      if (!d.pv.empty() && d.depth > 0) results.push_back({s->id(), d.depth, d.score, Move2MiniMove(d.pv[0])});
+   }
+   if (results.size() < 2) return id();
+
+   ScoreType minScore = results[0].score;
+   for (const auto& r : results) minScore = std::min(minScore, r.score);
+   std::vector<std::pair<MiniMove, int64_t>> votes;
+   for (const auto& r : results) {
+      const int64_t w = static_cast<int64_t>(r.score - minScore + 14) * r.depth;
+      auto it = std::find_if(votes.begin(), votes.end(), [&](const auto& v) { return v.first == r.m; });
+      if (it == votes.end()) votes.emplace_back(r.m, w);
+      else it->second += w;
+   }
+   auto vote = [&](const MiniMove m) { return std::find_if(votes.begin(), votes.end(), [&](const auto& v) { return v.first == m; })->second; };
+
+   // main thread result first (if available)
+   const Result* best = &results[0];
+   for (const auto& r : results) {
+      // prefer the shortest mate found
+      if (isMatingScore(best->score)) {
+         if (r.score > best->score) best = &r;
+      }
+      else if (isMatingScore(r.score) || (!isMatedScore(r.score) && vote(r.m) > vote(best->m))) {
+         best = &r;
+      }
+   }
+   if (best->id != id()) {
+      Logging::LogIt(Logging::logInfo) << "Better thread ! " << best->id << ", depth " << static_cast<int>(best->depth) << ", score " << best->score
+                                       << ", move " << ToString(best->m) << " (" << vote(best->m) << " votes)";
+   }
+   return best->id;
+}
+
 void Searcher::searchDriver(bool postMove) {
    //stopFlag = false; // shall be only done outside to avoid race condition
    height_ = 0;
@@ -75,6 +149,8 @@ void Searcher::searchDriver(bool postMove) {
    NNUEEvaluator nnueEvaluator;
    p.associateEvaluator(nnueEvaluator);
    p.resetNNUEEvaluator(nnueEvaluator);
+   // net may have changed since last search
+   nnueFinny.clear();
 #endif
 
    //if (isMainThread()) p.initCaslingPermHashTable(); // let's be sure ...
@@ -130,8 +206,8 @@ void Searcher::searchDriver(bool postMove) {
    // other threads will wait here for start signal
    else {
       Logging::LogIt(Logging::logInfo) << "helper thread waiting ... " << id();
-      while (startLock.load()) { ; }
-      Logging::LogIt(Logging::logInfo) << "... go for id " << id();
+      startLock.wait(true); // passive wait (futex like), see releaseOthers
+      Logging::LogIt(Logging::logInfo) << "... go for id " << id() << " (" << ThreadPool::instance().usSinceStart() << "us after search request)";
    }
 
    // fill "root" position stack data
@@ -139,14 +215,21 @@ void Searcher::searchDriver(bool postMove) {
       EvalData  eData;
       ScoreType e = eval(p, eData, *this, true);
       assert(p.halfmoves < MAX_PLY && p.halfmoves >= 0);
-      stack[p.halfmoves] = {p, computeHash(p), /*eData,*/ e, INVALIDMINIMOVE};
+      stack[p.halfmoves].set(p, computeHash(p));
+      stack[p.halfmoves].eval   = e;
+      stack[p.halfmoves].threat = INVALIDMINIMOVE;
    }
+   initGameHistory(p);
 
    // reset output search results
    _data.reset();
 
    const bool isInCheck = isPosInCheck(p);
 
+   // helper threads depth scheduling (not for co-searcher)
+   const bool depthCountPolicy = DynamicConfig::smpPolicy == "depthCount";
+   const bool isHelper = !isMainThread() && !subSearch;
+
    // initialize multiPV stuff
    DynamicConfig::multiPV = (Logging::ct == Logging::CT_uci ? DynamicConfig::multiPV : 1);
    if (Skill::enabled() && !DynamicConfig::nodesBasedLevel) { DynamicConfig::multiPV = std::max(DynamicConfig::multiPV, 4u); }
@@ -194,7 +277,8 @@ void Searcher::searchDriver(bool postMove) {
    // forced move detection
    // only main thread here (stopflag will be triggered anyway for other threads if needed)
    if (isMainThread() && DynamicConfig::multiPV == 1 && isFiniteTimeSearch && currentMoveMs > 100) { ///@todo should work with nps here
-      _data.score = pvs<true>(matedScore(0), matingScore(0), p, 1, 0, _data.pv, _data.seldepth, 0, isInCheck, false); // depth 1 search to get real valid moves
+      _data.score = pvs<true>(matedScore(0), matingScore(0), p, 1, 0, _data.seldepth, 0, isInCheck, false); // depth 1 search to get real valid moves
+      _data.pv = getPVFromTable();
       // only one : check evasion or zugzwang
       if (rootScores.size() == 1) {
          moveDifficulty = MoveDifficultyUtil::MD_forced;
@@ -204,6 +288,12 @@ void Searcher::searchDriver(bool postMove) {
    // ID loop
    for (DepthType depth = 1; depth <= targetMaxDepth && !stopFlag; ++depth) {
 
+      if (isHelper && skipDepth(id(), depth, depthCountPolicy)) {
+         Logging::LogIt(Logging::logInfo) << "Thread " << id() << " skipping depth " << static_cast<int>(depth);
+         continue; // next depth
+      }
+      const DepthRegistration depthRegistration(depth, depthCountPolicy && !subSearch);
+
       // MultiPV loop
       std::vector<MiniMove> skipMoves;
       for (unsigned int multi = 0; multi < DynamicConfig::multiPV && !stopFlag; ++multi) {
@@ -215,18 +305,10 @@ void Searcher::searchDriver(bool postMove) {
                // delayed other thread start (can use a depth condition...)
                if (startLock.load()) {
                   Logging::LogIt(Logging::logInfo) << "Unlocking other threads";
-                  startLock.store(false);
+                  releaseOthers();
                }
             }
          }
-         // stockfish like thread management (not for co-searcher)
-         else if (!subSearch) {
-            const auto i = (id() - 1) % threadSkipSize;
-            if (((depth + skipPhase[i]) / skipSize[i]) % 2){
-               Logging::LogIt(Logging::logInfo) << "Thread " << id() << " skipping depth " << static_cast<int>(depth);
-               continue; // next depth
-            }
-         }
 
          Logging::LogIt(Logging::logInfo) << "Thread " << id() << " searching depth " << static_cast<int>(depth);
 
@@ -254,8 +336,8 @@ void Searcher::searchDriver(bool postMove) {
 
          // Aspiration loop
          while (!stopFlag) {
-            pvLoc.clear();
-            score = pvs<true>(alpha, beta, p, windowDepth, 0, pvLoc, _data.seldepth, 0, isInCheck, false, skipMoves.empty() ? nullptr : &skipMoves);
+            score = pvs<true>(alpha, beta, p, windowDepth, 0, _data.seldepth, 0, isInCheck, false, skipMoves.empty() ? nullptr : &skipMoves);
+            pvLoc = getPVFromTable();
             if (stopFlag) break;
             ScoreType matW = 0;
             ScoreType matB = 0;
@@ -327,7 +409,7 @@ void Searcher::searchDriver(bool postMove) {
             if (isMainThread() && multi == 0) {
                // store current depth info
                getSearchData().scores[depth] = _data.score;
-               getSearchData().nodes[depth]  = ThreadPool::instance().counter(Stats::sid_nodes) + ThreadPool::instance().counter(Stats::sid_qnodes);
+               getSearchData().nodes[depth]  = ThreadPool::instance().nodeCount();
                if (!pvLoc.empty()) getSearchData().moves[depth] = Move2MiniMove(pvLoc[0]);
 
                // check for an emergency : 
@@ -385,8 +467,7 @@ void Searcher::searchDriver(bool postMove) {
       if (isMainThread() || isStoppableCoSearcher) {
          // restore real value (only on main processus!), was discarded for depth 1 search
          if (Distributed::isMainProcess()) TimeMan::maxNodes = maxNodes;
-         const Counter nodeCount = isStoppableCoSearcher ? stats.counters[Stats::sid_nodes] + stats.counters[Stats::sid_qnodes]
-                                 : ThreadPool::instance().counter(Stats::sid_nodes) + ThreadPool::instance().counter(Stats::sid_qnodes);
+         const Counter nodeCount = isStoppableCoSearcher ? stats.nodes() : ThreadPool::instance().nodeCount();
          if (TimeMan::maxNodes > 0 && nodeCount > TimeMan::maxNodes) {
             stopFlag = true;
             Logging::LogIt(Logging::logInfo) << "stopFlag triggered in search driver (nodes limits) in thread " << id();
@@ -405,7 +486,7 @@ pvsout:
    if (isMainThread()) {
       // in case of very very short depth or time, "others" threads may still be blocked
       Logging::LogIt(Logging::logInfo) << "Unlocking other threads (end of search)";
-      startLock.store(false);
+      releaseOthers();
 
       // all threads are updating their output values but main one is looking for the longest pv
       // note that depth, score, seldepth and pv are already updated on-the-fly
@@ -416,19 +497,14 @@ pvsout:
          // !!! warning: when skill uses multiPV, returned move shall be used and not first move of pv in receiveMoves !!!
          if (Skill::enabled() && !DynamicConfig::nodesBasedLevel) { _data.best = Skill::pick(multiPVMoves); }
          else {
-            // get pv from best (deepest) threads
-            DepthType bestDepth    = _data.depth;
-            size_t    bestThreadId = 0;
-            for (const auto& s : ThreadPool::instance()) {
-               std::unique_lock<std::mutex> lock(_mutexPV);
-               if (s->getData().depth > bestDepth) {
-                  bestThreadId = s->id();
-                  bestDepth    = s->getData().depth;
-                  Logging::LogIt(Logging::logInfo) << "Better thread ! " << bestThreadId << ", depth " << static_cast<int>(bestDepth);
-               }
-            }
+            // get pv from best thread
+            const size_t bestThreadId = pickBestThread();
             // update data with best data available
-            _data      = ThreadPool::instance()[bestThreadId]->getData();
+            if (bestThreadId != id()) {
+               Searcher & best = *ThreadPool::instance()[bestThreadId];
+               std::unique_lock<std::mutex> lock(best._mutexPV);
+               _data = best.getData();
+            }
             _data.best = _data.pv[0]; ///@todo this can lead to best move not being coherent with last reported PV
          }
          // update stack data on all searcher with "real" score
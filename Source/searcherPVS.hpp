@@ -5,7 +5,6 @@
 #include "dynamicConfig.hpp"
 #include "egt.hpp"
 #include "evalConfig.hpp"
-#include "evalTools.hpp"
 #include "moveGen.hpp"
 #include "moveSort.hpp"
 #include "positionTools.hpp"
@@ -216,7 +215,7 @@ Searcher::depthPolicy( [[maybe_unused]] const Position & p,
 
          // aggressive random reduction (again a threading try...)
          /*
-         const ScoreType randomShot = (stats.counters[Stats::sid_nodes] + stats.counters[Stats::sid_qnodes]) % 128;
+         const ScoreType randomShot = stats.nodes() % 128;
          if ( randomShot > 128 + SearchConfig::lmpLimit[pvsData.improving][depth + depthCorrection] - SearchConfig::randomAggressiveReductionFactor * validQuietMoveCount) {
             stats.incr(Stats::sid_lmrAR);
             ++reduction;
@@ -270,7 +269,7 @@ Searcher::depthPolicy( [[maybe_unused]] const Position & p,
 
          // capture history reduction
          const Square to = Move2To(m); // ok this is a std capture (no ep)
-         const int hScore = HISTORY_DIV(SearchConfig::lmrCapHistoryFactor * historyT.historyCap[PieceIdx(p.board_const(Move2From(m)))][to][Abs(p.board_const(to))-1]);
+         const int hScore = HISTORY_DIV(SearchConfig::lmrCapHistoryFactor * historyT.cap(p.board_const(Move2From(m)), to, p.board_const(to)));
          reduction -= std::max(-2,std::min(2, hScore));
 
          // -----------------------
@@ -298,12 +297,8 @@ Searcher::depthPolicy( [[maybe_unused]] const Position & p,
 #pragma GCC diagnostic ignored "-Wconversion"
 
 FORCE_FINLINE void evalFeatures(const Position & p,
-                         array2d<BitBoard,2,6> & attFromPiece,
-                         colored<BitBoard>     & att,
-                         colored<BitBoard>     & att2,
-                         array2d<BitBoard,2,6> & checkers,
+                         BBTools::AttackMap    & attacks,
                          colored<ScoreType>    & kdanger,
-                         EvalScore             & mobilityScore,
                          colored<uint16_t>     & mobility){
 
    const bool kingIsMandatory = DynamicConfig::isKingMandatory();
@@ -314,25 +309,25 @@ FORCE_FINLINE void evalFeatures(const Position & p,
                                        isValidSquare(p.king[Co_Black]) ? BBTools::mask[p.king[Co_Black]].kingZone : emptyBitBoard};
    const BitBoard occupancy = p.occupancy();
 
+   attacks.compute(p, [&](const Color c, const Piece pp, const Square k, const BitBoard target) {
+      // aligned threats removing own piece (not pawn) in occupancy
+      const BitBoard shadowTarget = BBTools::pfCoverage[pp - 1](k, occupancy ^ nonPawnMat[c], c);
+      kdanger[~c] += BB::countBit(shadowTarget & kingZone[~c]) * EvalConfig::kingAttWeight[EvalConfig::katt_attack][pp - 1];
+      kdanger[c] -= BB::countBit(target & kingZone[c]) * EvalConfig::kingAttWeight[EvalConfig::katt_defence][pp - 1];
+   });
+   // pawns one by one, a pawn has at most one target on each side
+   const array2d<BitBoard,2,2> pawnTargets = {{{{BBTools::shiftNW<Co_White>(pawns[Co_White]), BBTools::shiftNE<Co_White>(pawns[Co_White])}},
+                                               {{BBTools::shiftNW<Co_Black>(pawns[Co_Black]), BBTools::shiftNE<Co_Black>(pawns[Co_Black])}}}};
    for (Color c = Co_White ; c <= Co_Black ; ++c){
-      for (Piece pp = P_wp ; pp <= P_wk ; ++pp){
-         BB::applyOn(p.pieces_const(c,pp), [&](const Square & k) {
-            // aligned threats removing own piece (not pawn) in occupancy
-            const BitBoard shadowTarget = BBTools::pfCoverage[pp - 1](k, occupancy ^ nonPawnMat[c], c);
-            if (shadowTarget) {
-               kdanger[~c] += BB::countBit(shadowTarget & kingZone[~c]) * EvalConfig::kingAttWeight[EvalConfig::katt_attack][pp - 1];
-               const BitBoard target = BBTools::pfCoverage[pp - 1](k, occupancy, c); // real targets
-               if (target) {
-                  attFromPiece[c][pp - 1] |= target;
-                  att2[c] |= att[c] & target;
-                  att[c] |= target;
-                  if (target & p.pieces_const<P_wk>(~c)) checkers[c][pp - 1] |= SquareToBitboard(k);
-                  kdanger[c] -= BB::countBit(target & kingZone[c]) * EvalConfig::kingAttWeight[EvalConfig::katt_defence][pp - 1];
-               }
-            }
-         });
+      for (const BitBoard target : pawnTargets[c]) {
+         kdanger[~c] += BB::countBit(target & kingZone[~c]) * EvalConfig::kingAttWeight[EvalConfig::katt_attack][P_wp - 1];
+         kdanger[c] -= BB::countBit(target & kingZone[c]) * EvalConfig::kingAttWeight[EvalConfig::katt_defence][P_wp - 1];
       }
    }
+   const colored<BitBoard>     & att          = attacks.all;
+   const colored<BitBoard>     & att2         = attacks.twice;
+   const array2d<BitBoard,2,6> & attFromPiece = attacks.byPiece;
+   const array2d<BitBoard,2,6> & checkers     = attacks.checkers;
 
    if (kingIsMandatory){
      const File wkf = SQFILE(p.king[Co_White]);
@@ -364,23 +359,15 @@ FORCE_FINLINE void evalFeatures(const Position & p,
       kdanger[Co_Black] += EvalConfig::kingAttSafeCheck[pp - 1] * BB::countBit(checkers[Co_White][pp - 1] & safeSquare[Co_White]);
    }
 
-   // pieces mobility (second attack loop needed, knowing safeSquare ...)
-   const colored<BitBoard> knights = {p.whiteKnight(), p.blackKnight()};
-   const colored<BitBoard> bishops = {p.whiteBishop(), p.blackBishop()};
-   const colored<BitBoard> rooks   = {p.whiteRook(), p.blackRook()};
-   const colored<BitBoard> queens  = {p.whiteQueen(), p.blackQueen()};
-   const colored<BitBoard> kings   = {p.whiteKing(), p.blackKing()};
-
-   evalMob<P_wn, Co_White>(p, knights[Co_White], mobilityScore, safeSquare[Co_White], occupancy, mobility[Co_White]);
-   evalMob<P_wb, Co_White>(p, bishops[Co_White], mobilityScore, safeSquare[Co_White], occupancy, mobility[Co_White]);
-   evalMob<P_wr, Co_White>(p, rooks  [Co_White], mobilityScore, safeSquare[Co_White], occupancy, mobility[Co_White]);
-   evalMobQ<     Co_White>(p, queens [Co_White], mobilityScore, safeSquare[Co_White], occupancy, mobility[Co_White]);
-   evalMobK<     Co_White>(p, kings  [Co_White], mobilityScore, ~att[Co_Black]      , occupancy, mobility[Co_White]);
-   evalMob<P_wn, Co_Black>(p, knights[Co_Black], mobilityScore, safeSquare[Co_Black], occupancy, mobility[Co_Black]);
-   evalMob<P_wb, Co_Black>(p, bishops[Co_Black], mobilityScore, safeSquare[Co_Black], occupancy, mobility[Co_Black]);
-   evalMob<P_wr, Co_Black>(p, rooks  [Co_Black], mobilityScore, safeSquare[Co_Black], occupancy, mobility[Co_Black]);
-   evalMobQ<     Co_Black>(p, queens [Co_Black], mobilityScore, safeSquare[Co_Black], occupancy, mobility[Co_Black]);
-   evalMobK<     Co_Black>(p, kings  [Co_Black], mobilityScore, ~att[Co_White]      , occupancy, mobility[Co_Black]);   
+   // pieces mobility count (knowing safeSquare ...), only the sum is needed here so that sliders are done set-wise
+   for (Color c = Co_White ; c <= Co_Black ; ++c){
+      const BitBoard target = ~p.allPieces[c] & safeSquare[c];
+      const BitBoard queens = p.pieces_const<P_wq>(c);
+      mobility[c] += BBTools::mobilitySet<P_wb>(p.pieces_const<P_wb>(c) | queens, occupancy, target) +
+                     BBTools::mobilitySet<P_wr>(p.pieces_const<P_wr>(c) | queens, occupancy, target);
+      BB::applyOn(p.pieces_const<P_wn>(c), [&](const Square & k){ mobility[c] += BB::countBit(BBTools::mask[k].knight & target); });
+      BB::applyOn(p.pieces_const<P_wk>(c), [&](const Square & k){ mobility[c] += BB::countBit(BBTools::mask[k].king & ~p.allPieces[c] & ~att[~c]); });
+   }
 }
 
 #pragma GCC diagnostic pop
@@ -410,8 +397,7 @@ FORCE_FINLINE void Searcher::timeCheck(){
    static uint64_t periodicCheck = 0ull; ///@todo this is slow because of guard variable
    if (periodicCheck == 0ull) {
       periodicCheck = (TimeMan::maxNodes > 0) ? std::min(TimeMan::maxNodes, PERIODICCHECK) : PERIODICCHECK;
-      const Counter nodeCount = isStoppableCoSearcher ? stats.counters[Stats::sid_nodes] + stats.counters[Stats::sid_qnodes]
-                                : ThreadPool::instance().counter(Stats::sid_nodes) + ThreadPool::instance().counter(Stats::sid_qnodes);
+      const Counter nodeCount = isStoppableCoSearcher ? stats.nodes() : ThreadPool::instance().nodeCount();
       if (TimeMan::maxNodes > 0 && nodeCount > TimeMan::maxNodes) {
          stopFlag = true;
          Logging::LogIt(Logging::logInfo) << "stopFlag triggered (nodes limits) in thread " << id();
@@ -439,13 +425,15 @@ ScoreType Searcher::pvs(ScoreType                    alpha,
                         const Position&              p,
                         DepthType                    depth,
                         DepthType                    height,
-                        PVList&                      pv,
                         DepthType&                   seldepth,
                         DepthType                    extensions,
                         bool                         isInCheck_,
                         bool                         cutNode_,
                         const std::vector<MiniMove>* skipMoves) {
 
+   // this node PV line is empty until a move raises alpha
+   clearPV(height);
+
    // stopFlag management and time check. Only on main thread and not at each node (see PERIODICCHECK)
    if (isMainThread() || isStoppableCoSearcher) timeCheck();
    if (stopFlag) return STOPSCORE;
@@ -494,7 +482,7 @@ ScoreType Searcher::pvs(ScoreType                    alpha,
    seldepth = std::max(seldepth,height);
 
    // update nodes count as soon as we "really enter" a node
-   ++stats.counters[Stats::sid_nodes];
+   stats.incrNodes(Stats::sid_nodes);
 
    if (pvsData.rootnode){
       // all threads clear rootScore, this is usefull for helper like in genfen or rescore.
@@ -728,13 +716,9 @@ ScoreType Searcher::pvs(ScoreType                    alpha,
    // take **current** position danger level into account for purning
    // no HCE has been done, we need to work a little to get data from evaluation of the position
    if (!evalData.evalDone) {
-      EvalScore mobilityScore = {0, 0};
-      array2d<BitBoard,2,6> checkers     = {{emptyBitBoard}};
-      array2d<BitBoard,2,6> attFromPiece = {{emptyBitBoard}};
-      colored<BitBoard> att              = {emptyBitBoard, emptyBitBoard};
-      colored<BitBoard> att2             = {emptyBitBoard, emptyBitBoard};
-
-      evalFeatures(p, attFromPiece, att, att2, checkers, evalData.danger, mobilityScore, evalData.mobility);
+      evalFeatures(p, evalData.attacks, evalData.danger, evalData.mobility);
+      const colored<BitBoard>     & att          = evalData.attacks.all;
+      const array2d<BitBoard,2,6> & attFromPiece = evalData.attacks.byPiece;
 
       evalData.haveThreats[Co_White] = (att[Co_White] & p.allPieces[Co_Black]) != emptyBitBoard;
       evalData.haveThreats[Co_Black] = (att[Co_Black] & p.allPieces[Co_White]) != emptyBitBoard;
@@ -839,9 +823,8 @@ ScoreType Searcher::pvs(ScoreType                    alpha,
              pvsData.withoutSkipMove &&
              (evalScore == beta || evalScore >= beta + SearchConfig::nullMoveMargin) && 
              evalScore >= stack[p.halfmoves].eval &&
-             stack[p.halfmoves].p.lastMove != NULLMOVE && 
+             stack[p.halfmoves].lastMove != NULLMOVE && 
              (height >= nullMoveMinPly || nullMoveVerifColor != p.c)) {
-            PVList nullPV;
             stats.incr(Stats::sid_nullMoveTry);
             const DepthType R = SearchConfig::nullMoveReductionInit +
                               depth / SearchConfig::nullMoveReductionDepthDivisor + 
@@ -850,9 +833,8 @@ ScoreType Searcher::pvs(ScoreType                    alpha,
             Position pN = p;
             applyNull(*this, pN);
             assert(pN.halfmoves < MAX_PLY && pN.halfmoves >= 0);
-            stack[pN.halfmoves].p = pN; ///@todo another expensive copy !!!!
-            stack[pN.halfmoves].h = pN.h;
-            ScoreType nullscore   = -pvs<false>(-beta, -beta + 1, pN, nullDepth, height + 1, nullPV, seldepth, extensions, pvsData.isInCheck, !pvsData.cutNode);
+            stack[pN.halfmoves].set(pN, pN.h);
+            ScoreType nullscore   = -pvs<false>(-beta, -beta + 1, pN, nullDepth, height + 1, seldepth, extensions, pvsData.isInCheck, !pvsData.cutNode);
             if (stopFlag) return STOPSCORE;
             TT::Entry nullEThreat;
             TT::getEntry(*this, pN, computeHash(pN), 0, nullEThreat);
@@ -863,7 +845,7 @@ ScoreType Searcher::pvs(ScoreType                    alpha,
                   stats.incr(Stats::sid_nullMoveTry3);
                   nullMoveMinPly = height + 3*nullDepth/4;
                   nullMoveVerifColor = p.c;
-                  nullscore = pvs<false>(beta - 1, beta, p, nullDepth, height+1, nullPV, seldepth, extensions, pvsData.isInCheck, false);
+                  nullscore = pvs<false>(beta - 1, beta, p, nullDepth, height+1, seldepth, extensions, pvsData.isInCheck, false);
                   nullMoveMinPly = 0;
                   nullMoveVerifColor = Co_None;
                   if (stopFlag) return STOPSCORE;
@@ -890,12 +872,12 @@ ScoreType Searcher::pvs(ScoreType                    alpha,
             MoveGen::generate<MoveGen::GP_cap>(p, moves);
             //if (moves.empty()) stats.incr(Stats::sid_probcutNoCap); // should be 0 as there is threats ...
    #ifdef USE_PARTIAL_SORT
-            MoveSorter::score(*this, moves, p, evalData.gp, height, pvsData.cmhPtr, true, pvsData.isInCheck, pvsData.validTTmove ? &e : nullptr);
+            MoveSorter::score(*this, moves, p, evalData.gp, height, pvsData.cmhPtr, true, pvsData.isInCheck, pvsData.validTTmove ? &e : nullptr, INVALIDMINIMOVE, &evalData.attacks);
             size_t offset = 0;
             const Move* it = nullptr;
             while ((it = MoveSorter::pickNext(moves, offset)) && probCutCount < SearchConfig::probCutMaxMoves /*+ 2*pvsData.cutNode*/) {
    #else
-            MoveSorter::scoreAndSort(*this, moves, p, evalData.gp, height, pvsData.cmhPtr, true, pvsData.isInCheck, pvsData.validTTmove ? &e : nullptr);
+            MoveSorter::scoreAndSort(*this, moves, p, evalData.gp, height, pvsData.cmhPtr, true, pvsData.isInCheck, pvsData.validTTmove ? &e : nullptr, INVALIDMINIMOVE, &evalData.attacks);
             for (auto it = moves.begin(); it != moves.end() && probCutCount < SearchConfig::probCutMaxMoves /*+ 2*pvsData.cutNode*/; ++it) {
    #endif
                stats.incr(Stats::sid_probcutMoves);
@@ -904,18 +886,15 @@ ScoreType Searcher::pvs(ScoreType                    alpha,
                const Position::MoveInfo moveInfo(p2,*it);
                if (!applyMove(p2, moveInfo, true)) continue;
    #ifdef WITH_NNUE
-               NNUEEvaluator newEvaluator = p.evaluator();
-               p2.associateEvaluator(newEvaluator);
-               applyMoveNNUEUpdate(p2, moveInfo);
+               applyMoveNNUELazyUpdate(p2, nnueStack[height + 1], moveInfo);
    #endif
                ++probCutCount;
                ScoreType scorePC = -qsearch(-betaPC, -betaPC + 1, p2, height + 1, seldepth, 0, true, pvnode);
-               PVList pcPV;
                if (stopFlag) return STOPSCORE;
                const DepthType probCutSearchDepth = depth / SearchConfig::probCutSearchDepthFactor;
                if (scorePC >= betaPC) {
                   stats.incr(Stats::sid_probcutTry2);
-                  scorePC = -pvs<false>(-betaPC, -betaPC + 1, p2, probCutSearchDepth, height + 1, pcPV, seldepth, extensions, 
+                  scorePC = -pvs<false>(-betaPC, -betaPC + 1, p2, probCutSearchDepth, height + 1, seldepth, extensions, 
                                        isPosInCheck(p2), !pvsData.cutNode);
                }
                if (stopFlag) return STOPSCORE;
@@ -953,8 +932,8 @@ ScoreType Searcher::pvs(ScoreType                    alpha,
    if (SearchConfig::doIID && !pvsData.validTTmove /*|| e.d < depth-4*/) {
       if ((pvnode && depth >= SearchConfig::iidMinDepth) || (pvsData.cutNode && depth >= SearchConfig::iidMinDepth2)) { ///@todo try with cutNode only ?
          stats.incr(Stats::sid_iid);
-         PVList iidPV;
-         DISCARD pvs<pvnode>(alpha, beta, p, depth / 2, height, iidPV, seldepth, extensions, pvsData.isInCheck, pvsData.cutNode, skipMoves);
+         DISCARD pvs<pvnode>(alpha, beta, p, depth / 2, height, seldepth, extensions, pvsData.isInCheck, pvsData.cutNode, skipMoves);
+         clearPV(height); // IID line is not this node PV
          if (stopFlag) return STOPSCORE;
          TT::getEntry(*this, p, pHash, 0, e);
          pvsData.ttHit       = e.h != nullHash;
@@ -1027,6 +1006,22 @@ ScoreType Searcher::pvs(ScoreType                    alpha,
 
    TT::Bound hashBound = TT::B_alpha;
    
+#ifdef USE_LEGAL_MOVEGEN
+   // pin and check masks (computed lazily), so that illegal moves are never copied nor applied
+   std::optional<MoveGen::LegalMasks> legalMasks;
+   const auto isLegal = [&](const Move m){
+      if (!legalMasks) legalMasks.emplace(p);
+      return MoveGen::isLegal(p, m, *legalMasks);
+   };
+#else
+   const auto isLegal = [](const Move){ return true; }; // applyMove validates
+#endif
+
+#ifdef WITH_MAKE_UNMAKE_SEARCH
+   // scratch position, each move is made and unmade on it (p is left untouched)
+   Position p2 = p;
+#endif
+
    // try the tt move before move generation (if not skipped move)
    if (pvsData.validTTmove && 
        (moves.empty() || !pvsData.rootnode) && // avoid trying TT move at root if coming from a TB probe hit that filled moves
@@ -1040,18 +1035,20 @@ ScoreType Searcher::pvs(ScoreType                    alpha,
       pvsData.ttMoveTried = true;
       pvsData.isTTMove = true;
       bestMove = e.m; // in order to preserve tt move for alpha bound entry
+   }
 
+   // an illegal tt move is rejected before being copied or applied
+   if (pvsData.ttMoveTried && isLegal(e.m)) {
+#ifdef WITH_MAKE_UNMAKE_SEARCH
+      const Position::MoveInfo moveInfo(p2,e.m);
+      if (const ScopedMove made(p2, moveInfo, MoveGen::legalMoveGen); made.valid) {
+#else
       Position p2 = p;
-      if (const Position::MoveInfo moveInfo(p2,e.m); applyMove(p2, moveInfo, true)) {
+      if (const Position::MoveInfo moveInfo(p2,e.m); applyMove(p2, moveInfo, true, MoveGen::legalMoveGen)) {
+#endif
          // prefetch as soon as possible
          TT::prefetch(computeHash(p2));
 
-#ifdef WITH_NNUE
-         NNUEEvaluator newEvaluator = p.evaluator();
-         p2.associateEvaluator(newEvaluator);
-         applyMoveNNUEUpdate(p2, moveInfo);
-#endif
-
          ++pvsData.validMoveCount;
          ++pvsData.validNonPrunedCount;
 
@@ -1063,8 +1060,7 @@ ScoreType Searcher::pvs(ScoreType                    alpha,
          pvsData.isCheck = pvsData.ttIsCheck || isPosInCheck(p2);
 
          assert(p2.halfmoves < MAX_PLY && p2.halfmoves >= 0);
-         stack[p2.halfmoves].p = p2; ///@todo another expensive copy !!!!
-         stack[p2.halfmoves].h = p2.h;
+         stack[p2.halfmoves].set(p2, p2.h);
          
 #ifdef DEBUG_TT_CHECK
          if (pvsData.ttIsCheck && !isPosInCheck(p2)){
@@ -1087,10 +1083,9 @@ ScoreType Searcher::pvs(ScoreType                    alpha,
               && (pvsData.bound == TT::B_exact || pvsData.bound == TT::B_beta)
               && e.d >= depth - SearchConfig::singularExtensionDepthMinus) {
                const ScoreType betaC = e.s - 2 * depth;
-               PVList sePV;
                DepthType seSeldepth = 0;
                std::vector<MiniMove> skip{e.m};
-               const ScoreType score = pvs<false>(betaC - 1, betaC, p, depth / 2, height, sePV, seSeldepth, extensions, pvsData.isInCheck, pvsData.cutNode, &skip);
+               const ScoreType score = pvs<false>(betaC - 1, betaC, p, depth / 2, height, seSeldepth, extensions, pvsData.isInCheck, pvsData.cutNode, &skip);
                if (stopFlag) return STOPSCORE;
                if (score < betaC) { // TT move is singular
                   stats.incr(Stats::sid_singularExtension);
@@ -1108,15 +1103,19 @@ ScoreType Searcher::pvs(ScoreType                    alpha,
                }
                // if TT move is above beta, we try a reduce search early to see if another move is above beta (from SF)
                else if (e.s >= beta) {
-                  const ScoreType score2 = pvs<false>(beta - 1, beta, p, depth - 4, height, sePV, seSeldepth, extensions, pvsData.isInCheck, pvsData.cutNode, &skip);
+                  const ScoreType score2 = pvs<false>(beta - 1, beta, p, depth - 4, height, seSeldepth, extensions, pvsData.isInCheck, pvsData.cutNode, &skip);
                   if (score2 > beta) return stats.incr(Stats::sid_singularExtension4), beta; // fail-hard
                }
             }
          }
 
-         PVList childPV;
+#ifdef WITH_NNUE
+         // only now, as singular extension search above is using the same nnue stack slot
+         applyMoveNNUELazyUpdate(p2, nnueStack[height + 1], moveInfo);
+#endif
+
          ScoreType ttScore;
-         ttScore = -pvs<pvnode>(-beta, -alpha, p2, depth - 1 + extension, height + 1, childPV, seldepth, static_cast<DepthType>(extensions + extension), pvsData.isCheck, !pvsData.cutNode);
+         ttScore = -pvs<pvnode>(-beta, -alpha, p2, depth - 1 + extension, height + 1, seldepth, static_cast<DepthType>(extensions + extension), pvsData.isCheck, !pvsData.cutNode);
 
          if (stopFlag) return STOPSCORE;
 
@@ -1132,7 +1131,7 @@ ScoreType Searcher::pvs(ScoreType                    alpha,
             if (ttScore > alpha) {
                hashBound = TT::B_exact;
                pvsData.alphaUpdated = true;
-               if constexpr(pvnode) updatePV(pv, bestMove, childPV);
+               if constexpr(pvnode) updatePV(height, bestMove);
                if (ttScore >= beta) {
                   stats.incr(Stats::sid_ttbeta);
 
@@ -1166,26 +1165,24 @@ ScoreType Searcher::pvs(ScoreType                    alpha,
    bool skipQuiet = false;
    bool skipCap = false;
 
+   // staged move generation (captures, refutations and then quiets, see MovePicker and USE_STAGED_MOVEGEN), 
+   // except at root, when in check or for variants with mandatory moves.
    // depending if probecut already generates capture or not, generate all moves or only missing quiets
-   if (!moveGenerated) {
+   const bool staged = stagedMoveGen && !moveGenerated && !pvsData.rootnode && !pvsData.isInCheck && !DynamicConfig::anarchy && !DynamicConfig::antichess;
+   if (!moveGenerated && !staged) {
       if (capMoveGenerated) MoveGen::generate<MoveGen::GP_quiet>(p, moves, true);
       else
          if ( pvsData.isInCheck ) MoveGen::generate<MoveGen::GP_evasion>(p, moves, false);
          else MoveGen::generate<MoveGen::GP_all>(p, moves, false);
    }
-   if (moves.empty()) return pvsData.isInCheck ? matedScore(height) : drawScore(p, height);
+   if (!staged && moves.empty()) return pvsData.isInCheck ? matedScore(height) : drawScore(p, height);
 
-#ifdef USE_PARTIAL_SORT
-   MoveSorter::score(*this, moves, p, evalData.gp, height, pvsData.cmhPtr, true, pvsData.isInCheck, pvsData.validTTmove ? &e : nullptr,
-                     refutation != INVALIDMINIMOVE && isCapture(Move2Type(refutation)) ? refutation : INVALIDMINIMOVE);
-   size_t offset = 0;
+   const MoveSorter sorter(*this, p, evalData.gp, height, pvsData.cmhPtr, true, pvsData.isInCheck, pvsData.validTTmove ? &e : nullptr,
+                           refutation != INVALIDMINIMOVE && isCapture(Move2Type(refutation)) ? refutation : INVALIDMINIMOVE, &evalData.attacks);
+   MovePicker picker(sorter, moves, staged ? (capMoveGenerated ? MovePicker::MP_scoreCap : MovePicker::MP_genCap) : MovePicker::MP_scoreAll,
+                     pvsData.validTTmove && pvsData.ttMoveTried ? static_cast<Move>(e.m) : INVALIDMOVE);
    const Move* it = nullptr;
-   while ((it = MoveSorter::pickNext(moves, offset)) && !stopFlag) {
-#else
-   MoveSorter::scoreAndSort(*this, moves, p, evalData.gp, height, pvsData.cmhPtr, true, pvsData.isInCheck, pvsData.validTTmove ? &e : nullptr,
-                            refutation != INVALIDMINIMOVE && isCapture(Move2Type(refutation)) ? refutation : INVALIDMINIMOVE);
-   for (auto it = moves.begin(); it != moves.end() && !stopFlag; ++it) {
-#endif
+   while ((it = picker.next()) && !stopFlag) {
 
       pvsData.isTTMove = false;
       pvsData.isQuiet = Move2Type(*it) == T_std && !isNoisy(p,*it);
@@ -1200,13 +1197,21 @@ ScoreType Searcher::pvs(ScoreType                    alpha,
          continue;
       }
       if (isSkipMove(*it, skipMoves)) continue;        // skipmoves
-      if (pvsData.validTTmove && pvsData.ttMoveTried && sameMove(e.m, *it)) continue; // already tried
+      if (!isLegal(*it)) continue;
+
+#ifdef WITH_MAKE_UNMAKE_SEARCH
+      const Position::MoveInfo moveInfo(p2,*it);
 
+      // do not apply NNUE update here, but later after prunning, right before next call to pvs
+      const ScopedMove made(p2, moveInfo, MoveGen::legalMoveGen);
+      if (!made.valid) continue;
+#else
       Position p2 = p;
       const Position::MoveInfo moveInfo(p2,*it);
 
       // do not apply NNUE update here, but later after prunning, right before next call to pvs
-      if (!applyMove(p2, moveInfo, true)) continue;
+      if (!applyMove(p2, moveInfo, true, MoveGen::legalMoveGen)) continue;
+#endif
 
       // prefetch as soon as possible
       TT::prefetch(computeHash(p2));
@@ -1223,20 +1228,16 @@ ScoreType Searcher::pvs(ScoreType                    alpha,
       pvsData.isAdvancedPawnPush = PieceTools::getPieceType(p, Move2From(*it)) == P_wp && (SQRANK(to) > 5 || SQRANK(to) < 2);
       pvsData.earlyMove = pvsData.validMoveCount < (2 /*+2*pvsData.rootnode*/);
 
-      PVList childPV;
       // PVS
       if (pvsData.earlyMove || !SearchConfig::doPVS){
-         stack[p2.halfmoves].p = p2;
-         stack[p2.halfmoves].h = p2.h;         
+         stack[p2.halfmoves].set(p2, p2.h);
 #ifdef WITH_NNUE
-         NNUEEvaluator newEvaluator = p.evaluator();
-         p2.associateEvaluator(newEvaluator);
-         applyMoveNNUEUpdate(p2, moveInfo);
+         applyMoveNNUELazyUpdate(p2, nnueStack[height + 1], moveInfo);
 #endif
          // get depth of next search
          // Remember that if no tt hit, depth has been reduced already (by IIR)
          const auto [nextDepth, extension, reduction] = depthPolicy(p, depth, height, *it, pvsData, evalData, evalScore, extensions, false);
-         score = -pvs<pvnode>(-beta, -alpha, p2, nextDepth, height + 1, childPV, seldepth, static_cast<DepthType>(extensions + extension), pvsData.isCheck, false);
+         score = -pvs<pvnode>(-beta, -alpha, p2, nextDepth, height + 1, seldepth, static_cast<DepthType>(extensions + extension), pvsData.isCheck, false);
          ++pvsData.validNonPrunedCount;
       }
       else {
@@ -1261,6 +1262,7 @@ ScoreType Searcher::pvs(ScoreType                    alpha,
             if (pvsData.lmp && pvsData.validMoveCount > SearchConfig::lmpLimit[pvsData.improving][depth + depthCorrection]) {
                stats.incr(Stats::sid_lmp);
                skipQuiet = true;
+               picker.skipQuiets();
                continue;
             }
 
@@ -1282,7 +1284,7 @@ ScoreType Searcher::pvs(ScoreType                    alpha,
          else{
             // capture history pruning (only std cap)
             if (pvsData.capHistoryPruning && isPrunableCap &&
-               historyT.historyCap[PieceIdx(p.board_const(Move2From(*it)))][to][Abs(p.board_const(to))-1] < SearchConfig::captureHistoryPruningCoeff.threshold(depth, evalData.gp, pvsData.improving, pvsData.cutNode)){
+               historyT.cap(p.board_const(Move2From(*it)), to, p.board_const(to)) < SearchConfig::captureHistoryPruningCoeff.threshold(depth, evalData.gp, pvsData.improving, pvsData.cutNode)){
                stats.incr(Stats::sid_capHistPruning);
                continue;
             }
@@ -1309,7 +1311,7 @@ ScoreType Searcher::pvs(ScoreType                    alpha,
          // SEE (quiet)
          ScoreType seeValue = 0;
          if (isPrunableStdNoCheck) {
-            seeValue = SEE(p, *it);
+            seeValue = SEE(p, *it, &evalData.attacks);
             if (!pvsData.rootnode && seeValue < - (SearchConfig::seeQuietInit + SearchConfig::seeQuietFactor * (nextDepth - 1) * (nextDepth + std::max(0, dangerGoodAttack - dangerUnderAttack)/SearchConfig::seeQuietDangerDivisor))){
                stats.incr(Stats::sid_seeQuiet);
                continue;
@@ -1321,18 +1323,14 @@ ScoreType Searcher::pvs(ScoreType                    alpha,
          ++pvsData.validNonPrunedCount;
 
          // PVS
-         stack[p2.halfmoves].p = p2;
-         stack[p2.halfmoves].h = p2.h;         
+         stack[p2.halfmoves].set(p2, p2.h);
 #ifdef WITH_NNUE
-         NNUEEvaluator newEvaluator = p.evaluator();
-         p2.associateEvaluator(newEvaluator);
-         applyMoveNNUEUpdate(p2, moveInfo);
+         applyMoveNNUELazyUpdate(p2, nnueStack[height + 1], moveInfo);
 #endif
-         score = -pvs<false>(-alpha - 1, -alpha, p2, nextDepth, height + 1, childPV, seldepth, static_cast<DepthType>(extensions + extension), pvsData.isCheck, true);
+         score = -pvs<false>(-alpha - 1, -alpha, p2, nextDepth, height + 1, seldepth, static_cast<DepthType>(extensions + extension), pvsData.isCheck, true);
          if (reduction > 0 && score > alpha) {
             stats.incr(Stats::sid_lmrFail);
-            childPV.clear();
-            score = -pvs<false>(-alpha - 1, -alpha, p2, depth - 1 + extension, height + 1, childPV, seldepth, static_cast<DepthType>(extensions + extension), pvsData.isCheck, !pvsData.cutNode);
+            score = -pvs<false>(-alpha - 1, -alpha, p2, depth - 1 + extension, height + 1, seldepth, static_cast<DepthType>(extensions + extension), pvsData.isCheck, !pvsData.cutNode);
 /*
             if (pvsData.isQuiet){
                if (score > alpha) historyT.update<1>(nextDepth, *it, p, pvsData.cmhPtr);
@@ -1348,9 +1346,8 @@ ScoreType Searcher::pvs(ScoreType                    alpha,
          }
          if ( score > alpha && (pvsData.rootnode || score < beta)) {
             stats.incr(Stats::sid_pvsFail);
-            childPV.clear();
             // potential new pv node
-            score = -pvs<true>(-beta, -alpha, p2, depth - 1 + extension, height + 1, childPV, seldepth, static_cast<DepthType>(extensions + extension), pvsData.isCheck, false);
+            score = -pvs<true>(-beta, -alpha, p2, depth - 1 + extension, height + 1, seldepth, static_cast<DepthType>(extensions + extension), pvsData.isCheck, false);
          }
       }
 
@@ -1366,7 +1363,7 @@ ScoreType Searcher::pvs(ScoreType                    alpha,
          pvsData.bestMoveIsCheck = pvsData.isCheck;
          //bestScoreUpdated = true;
          if (score > alpha) {
-            if constexpr(pvnode) updatePV(pv, bestMove, childPV);
+            if constexpr(pvnode) updatePV(height, bestMove);
             pvsData.alphaUpdated = true;
             alpha = score;
             hashBound = TT::B_exact;
@@ -1381,17 +1378,18 @@ ScoreType Searcher::pvs(ScoreType                    alpha,
                      // increase history of this move
                      updateTables(*this, p, bonusDepth, height, bestMove, TT::B_beta, pvsData.cmhPtr);
                      // reduce history of all previous
-                     for (auto it2 = moves.begin(); it2 != moves.end() && !sameMove(*it2, bestMove); ++it2) {
-                        if (Move2Type(*it2) == T_std)
-                           historyT.update<-1>(bonusDepth, *it2, p, pvsData.cmhPtr);
-                     }
+                     // (bestMove is the last picked one)
+                     picker.applyOnTried([&](const Move m) {
+                        if (Move2Type(m) == T_std && !sameMove(m, bestMove))
+                           historyT.update<-1>(bonusDepth, m, p, pvsData.cmhPtr);
+                     });
                   }
                   else if ( isCapture(bestMove)){ // capture history
                      historyT.updateCap<1>(bonusDepth, bestMove, p);
-                     for (auto it2 = moves.begin(); it2 != moves.end() && !sameMove(*it2, bestMove); ++it2) {
-                        if (isCapture(*it2))
-                           historyT.updateCap<-1>(bonusDepth, *it2, p);
-                     }
+                     picker.applyOnTried([&](const Move m) {
+                        if (isCapture(m) && !sameMove(m, bestMove))
+                           historyT.updateCap<-1>(bonusDepth, m, p);
+                     });
                   }
                }
                hashBound = TT::B_beta;
@@ -6,7 +6,7 @@ ScoreType Searcher::qsearchNoPruning(ScoreType alpha, ScoreType beta, const Posi
    height_ = height;
 
    EvalData data;
-   ++stats.counters[Stats::sid_qnodes];
+   stats.incrNodes(Stats::sid_qnodes);
    const ScoreType evalScore = eval(p, data, *this);
 
    if (evalScore >= beta) return evalScore;
@@ -79,7 +79,7 @@ ScoreType Searcher::qsearch(ScoreType       alpha,
    if (stopFlag) return STOPSCORE;
 
    // update nodes count as soon as we enter a node
-   ++stats.counters[Stats::sid_qnodes];
+   stats.incrNodes(Stats::sid_qnodes);
    //std::cout << GetFEN(p) << std::endl;
 
    alpha = std::max(alpha, matedScore(height));
@@ -188,18 +188,36 @@ ScoreType Searcher::qsearch(ScoreType       alpha,
    const ScoreType alphaInit      = alpha;
    int             validMoveCount = 0;
 
-   // we try the tt move before move generation
-   if (usableTTmove) {
+#ifdef USE_LEGAL_MOVEGEN
+   // pin and check masks (computed lazily), so that illegal moves are never copied nor applied
+   std::optional<MoveGen::LegalMasks> legalMasks;
+   const auto isLegal = [&](const Move m){
+      if (!legalMasks) legalMasks.emplace(p);
+      return MoveGen::isLegal(p, m, *legalMasks);
+   };
+#else
+   const auto isLegal = [](const Move){ return true; }; // applyMove validates
+#endif
+
+#ifdef WITH_MAKE_UNMAKE_SEARCH
+   // scratch position, each move is made and unmade on it (p is left untouched)
+   Position p2 = p;
+#endif
+
+   // we try the tt move before move generation (an illegal one is rejected before being copied or applied)
+   if (usableTTmove && isLegal(e.m)) {
+#ifdef WITH_MAKE_UNMAKE_SEARCH
+      const Position::MoveInfo moveInfo(p2,e.m);
+      if (const ScopedMove made(p2, moveInfo, MoveGen::legalMoveGen); made.valid) {
+#else
       Position p2 = p;
-      if (const Position::MoveInfo moveInfo(p2,e.m); applyMove(p2, moveInfo, true)) {
+      if (const Position::MoveInfo moveInfo(p2,e.m); applyMove(p2, moveInfo, true, MoveGen::legalMoveGen)) {
+#endif
 #ifdef WITH_NNUE
-         NNUEEvaluator newEvaluator = p.evaluator();
-         p2.associateEvaluator(newEvaluator);
-         applyMoveNNUEUpdate(p2, moveInfo);
+         applyMoveNNUELazyUpdate(p2, nnueStack[height + 1], moveInfo);
 #endif         
          ++validMoveCount;
-         //stack[p2.halfmoves].p = p2; ///@todo another expensive copy !!!!
-         //stack[p2.halfmoves].h = p2.h;
+         //stack[p2.halfmoves].set(p2, p2.h);
          TT::prefetch(computeHash(p2));
          const ScoreType score = -qsearch(-beta, -alpha, p2, height + 1, seldepth, isInCheck ? 0 : qply + 1, false, false);
          if (score > bestScore) {
@@ -235,17 +253,10 @@ ScoreType Searcher::qsearch(ScoreType       alpha,
    CMHPtrArray cmhPtr;
    getCMHPtr(p.halfmoves, cmhPtr);
 
-#ifdef USE_PARTIAL_SORT
-   MoveSorter::score(*this, moves, p, data.gp, height, cmhPtr, false, isInCheck, validTTmove ? &e : nullptr); ///@todo warning gp is often = 0.5 here !
-   size_t offset = 0;
+   const MoveSorter sorter(*this, p, data.gp, height, cmhPtr, false, isInCheck, validTTmove ? &e : nullptr); ///@todo warning gp is often = 0.5 here !
+   MovePicker picker(sorter, moves, MovePicker::MP_scoreAll, validTTmove ? static_cast<Move>(e.m) : INVALIDMOVE); // TT move already tried
    const Move* it = nullptr;
-   while ((it = MoveSorter::pickNext(moves, offset))) {
-#else
-   MoveSorter::scoreAndSort(*this, moves, p, data.gp, height, cmhPtr, false, isInCheck,
-                            validTTmove ? &e : nullptr); ///@todo warning gp is often = 0.5 here !
-   for (auto it = moves.begin(); it != moves.end(); ++it) {
-#endif
-      if (validTTmove && sameMove(e.m, *it)) continue; // already tried
+   while ((it = picker.next())) {
       if (!isInCheck) {
          if (onlyRecapture && Move2To(*it) != recapture) continue; // only recapture now ...
          if (SearchConfig::doQFutility && validMoveCount &&
@@ -254,7 +265,7 @@ ScoreType Searcher::qsearch(ScoreType       alpha,
             stats.incr(Stats::sid_qfutility);
             continue;
          }
-         const ScoreType seeValue = SEE(p,*it);
+         const ScoreType seeValue = SEE(p, *it, &data.attacks);
          // prune all bad captures
          if (seeValue < SearchConfig::seeQThreshold) {
             stats.incr(Stats::sid_qsee);
@@ -273,19 +284,23 @@ ScoreType Searcher::qsearch(ScoreType       alpha,
             return beta;
          }
       }
+      if (!isLegal(*it)) continue;
+#ifdef WITH_MAKE_UNMAKE_SEARCH
+      const Position::MoveInfo moveInfo(p2,*it);
+      const ScopedMove made(p2, moveInfo, MoveGen::legalMoveGen);
+      if (!made.valid) continue;
+#else
       Position p2 = p;
       const Position::MoveInfo moveInfo(p2,*it);
-      if (!applyMove(p2, moveInfo, true)) continue;
+      if (!applyMove(p2, moveInfo, true, MoveGen::legalMoveGen)) continue;
+#endif
       // prefetch as soon as possible
       TT::prefetch(computeHash(p2));
       ++validMoveCount;
 #ifdef WITH_NNUE
-      NNUEEvaluator newEvaluator = p.evaluator();
-      p2.associateEvaluator(newEvaluator);
-      applyMoveNNUEUpdate(p2, moveInfo);
+      applyMoveNNUELazyUpdate(p2, nnueStack[height + 1], moveInfo);
 #endif      
-      //stack[p2.halfmoves].p = p2;
-      //stack[p2.halfmoves].h = p2.h;
+      //stack[p2.halfmoves].set(p2, p2.h);
       const ScoreType score = -qsearch(-beta, -alpha, p2, height + 1, seldepth, isInCheck ? 0 : qply + 1, false, false);
       if (score > bestScore) {
          bestMove  = *it;
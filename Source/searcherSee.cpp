@@ -1,7 +1,7 @@
 #include "logging.hpp"
 #include "searcher.hpp"
 
-ScoreType Searcher::SEE(const Position& p, const Move& m) {
+ScoreType Searcher::SEE(const Position& p, const Move& m, const BBTools::AttackMap* attacks) {
    if (!isValidMove(m)) return 0;
 
    START_TIMER
@@ -13,7 +13,6 @@ ScoreType Searcher::SEE(const Position& p, const Move& m) {
    const Square to = correctedMove2ToKingDest(m);
    assert(isValidSquare(to));
 
-   BitBoard   attackers        = BBTools::allAttackedBB(p, to);
    BitBoard   occupationMask   = 0xFFFFFFFFFFFFFFFF;
    ScoreType  currentTargetVal = 0;
    const bool promPossible     = PROMOTION_RANK(to);
@@ -41,6 +40,14 @@ ScoreType Searcher::SEE(const Position& p, const Move& m) {
    ++nCapt;
    assert(nCapt < 64);
 
+   // nothing can recapture : target square is not attacked and no enemy slider can see through from square
+   if (attacks && attacks->done && mtype != T_ep &&
+       !((attacks->all[~c] & SquareToBitboard(to)) | (attacks->sliders(~c) & SquareToBitboard(from)))) {
+      STOP_AND_SUM_TIMER(See)
+      return swapList[0];
+   }
+
+   BitBoard attackers = BBTools::allAttackedBB(p, to);
    attackers &= ~SquareToBitboard(from);
    occupationMask &= ~SquareToBitboard(from);
    const BitBoard occupancy = p.occupancy();
@@ -96,4 +103,4 @@ ScoreType Searcher::SEE(const Position& p, const Move& m) {
    return swapList[0];
 }
 
-bool Searcher::SEE_GE(const Position& p, const Move& m, ScoreType threshold) { return SEE(p, m) >= threshold; }
+bool Searcher::SEE_GE(const Position& p, const Move& m, ScoreType threshold, const BBTools::AttackMap* attacks) { return SEE(p, m, attacks) >= threshold; }
@@ -6,8 +6,10 @@
 /*!
  * This array is used to store statistic of search and evaluation
  * for each thread.
+ * It is cache line aligned so that other threads reading node counts (see snapshot)
+ * don't share a cache line with other fields of the owning Searcher.
  */
-struct Stats {
+struct alignas(64) Stats {
    enum StatId {
       sid_nodes = 0,
       sid_qnodes,
@@ -238,6 +240,20 @@ struct Stats {
    FORCE_FINLINE void incr(StatId) {}
 #endif
 
+   // node counters are also read by other threads, relaxed atomic is still a plain increment on x86
+   FORCE_FINLINE void incrNodes(StatId id) {
+      std::atomic_ref<Counter> c(counters[id]);
+      c.store(c.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+   }
+
+   // owner thread node count
+   [[nodiscard]] FORCE_FINLINE Counter nodes() const { return counters[sid_nodes] + counters[sid_qnodes]; }
+
+   // relaxed read usable from any thread
+   [[nodiscard]] FORCE_FINLINE Counter snapshot(StatId id) const {
+      return std::atomic_ref<Counter>(const_cast<Counter&>(counters[id])).load(std::memory_order_relaxed);
+   }
+
    void init() {
       Logging::LogIt(Logging::logInfo) << "Init stat";
       counters.fill(0ull);
@@ -37,18 +37,20 @@ void HistoryT::initHistory() {
       for (int k = 0; k < NbSquare; ++k)
          history[0][i][k] = history[1][i][k] = 0;
 
-   for (int i = 0; i < NbPiece; ++i)
-      for (int k = 0; k < NbSquare; ++k)
-         historyP[i][k] = 0;
+   for (int c = 0; c < 2; ++c)
+      for (int i = 0; i < PieceShift; ++i)
+         for (int k = 0; k < NbSquare; ++k)
+            historyP[c][i][k] = 0;
 
-   for (int i = 0; i < NbPiece; ++i)
-      for (int j = 0; j < NbSquare; ++j)
-         for (int k = 0; k < 6; ++k)
-            historyCap[i][j][k] = 0;
+   for (int c = 0; c < 2; ++c)
+      for (int i = 0; i < PieceShift; ++i)
+         for (int j = 0; j < NbSquare; ++j)
+            for (int k = 0; k < PieceShift; ++k)
+               historyCap[c][i][j][k] = 0;
 
-   for (int i = 0; i < NbPiece; ++i)
+   for (int i = 0; i < 2 * PieceShift; ++i)
       for (int j = 0; j < NbSquare; ++j)
-         for (int k = 0; k < NbPiece * NbSquare; ++k)
+         for (int k = 0; k < PieceShift * NbSquare; ++k)
             counter_history[i][j][k] = -1;
 }
 
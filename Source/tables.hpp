@@ -9,13 +9,17 @@
  *  - Killers
  *  - History
  *     - Color/from/to
- *     - Piece/to
- *     - CMH history : previous moved piece/previous to/current moved piece & to
+ *     - Color/piece type/to
+ *     - CMH history : previous moved piece/previous to/current moved piece type & to
  *  - Counter : from/to
+ *
+ * Moved piece color is always the side to move one, so history tables are indexed by piece type
+ * (and color when needed) instead of NbPiece slots. This keeps HistoryT (embedded in each Searcher,
+ * so once per thread) around 600Kb instead of 1.4Mb.
  */
 
 inline constexpr int MAX_CMH_PLY = 1;
-using CMHPtrArray = array1d<array1d<ScoreType, NbPiece*NbSquare> *, MAX_CMH_PLY>;
+using CMHPtrArray = array1d<array1d<ScoreType, PieceShift*NbSquare> *, MAX_CMH_PLY>;
 
 struct KillerT {
    array2d<Move,MAX_DEPTH,2> killers;
@@ -26,13 +30,31 @@ struct KillerT {
 };
 
 struct HistoryT {
-   array3d<ScoreType,2,NbSquare,NbSquare> history;                       // Color, from, to
-   array3d<ScoreType,NbPiece,NbSquare,PieceShift> historyCap;            // Piece moved (+color), to, piece taken
-   array2d<ScoreType,NbPiece,NbSquare> historyP;                         // Piece, to
-   array3d<ScoreType,NbPiece,NbSquare,NbPiece*NbSquare> counter_history; // Previous moved piece, previous to, current moved piece * boardsize + current to
+   array3d<ScoreType,2,NbSquare,NbSquare> history;                             // Color, from, to
+   array3d<ScoreType,2,PieceShift,NbSquare> historyP;                          // Color, piece type, to
+   array1d<array3d<ScoreType,PieceShift,NbSquare,PieceShift>,2> historyCap;    // Color, piece type moved, to, piece type taken
+   array3d<ScoreType,2*PieceShift,NbSquare,PieceShift*NbSquare> counter_history; // Previous moved piece (+color), previous to, current moved piece type * boardsize + current to
 
    void initHistory();
 
+   // previous moved piece (with color) slot in counter_history
+   [[nodiscard]] static FORCE_FINLINE int cmhPrevIdx(const Piece pp) {
+      assert(pp != P_none);
+      return pp > 0 ? pp - 1 : PieceShift - pp - 1;
+   }
+   // current moved piece type and destination index inside a counter_history row
+   [[nodiscard]] static FORCE_FINLINE int cmhIdx(const Piece pp, const Square to) {
+      assert(pp != P_none);
+      return (Abs(pp) - 1) * NbSquare + to;
+   }
+   // pf is the (colored) piece moved, pt the piece taken
+   [[nodiscard]] FORCE_FINLINE ScoreType& cap(const Piece pf, const Square to, const Piece pt) {
+      return historyCap[pf < 0][Abs(pf) - 1][to][Abs(pt) - 1];
+   }
+   [[nodiscard]] FORCE_FINLINE ScoreType cap(const Piece pf, const Square to, const Piece pt) const {
+      return historyCap[pf < 0][Abs(pf) - 1][to][Abs(pt) - 1];
+   }
+
    template<int S> FORCE_FINLINE void update(DepthType depth, Move m, const Position& p, CMHPtrArray& cmhPtr) {
       if (Move2Type(m) == T_std) {
          const Color  c    = p.c;
@@ -43,10 +65,10 @@ struct HistoryT {
          const ScoreType s  = S * HSCORE(depth);
          const Piece     pp = p.board_const(from);
          history[c][from][to] += static_cast<ScoreType>(s - HISTORY_DIV(history[c][from][to] * Abs(s)));
-         historyP[PieceIdx(pp)][to] += static_cast<ScoreType>(s - HISTORY_DIV(historyP[PieceIdx(pp)][to] * Abs(s)));
+         historyP[c][Abs(pp) - 1][to] += static_cast<ScoreType>(s - HISTORY_DIV(historyP[c][Abs(pp) - 1][to] * Abs(s)));
          for (int i = 0; i < MAX_CMH_PLY; ++i) {
             if (cmhPtr[i]) {
-               ScoreType& item = (*cmhPtr[i])[PieceIdx(p.board_const(from)) * NbSquare + to];
+               ScoreType& item = (*cmhPtr[i])[cmhIdx(pp, to)];
                item += static_cast<ScoreType>(s - HISTORY_DIV(item * Abs(s)));
             }
          }
@@ -62,7 +84,8 @@ struct HistoryT {
          const Piece pf = p.board_const(from);
          const Piece pt = p.board_const(to); // std capture, no ep
          const ScoreType s  = S * HSCORE(depth);
-         historyCap[PieceIdx(pf)][to][Abs(pt)-1] += static_cast<ScoreType>(s - HISTORY_DIV(historyCap[PieceIdx(pf)][to][Abs(pt)-1] * Abs(s)));
+         ScoreType& item = cap(pf, to, pt);
+         item += static_cast<ScoreType>(s - HISTORY_DIV(item * Abs(s)));
       }
    }
 };
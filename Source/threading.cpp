@@ -40,7 +40,7 @@ void ThreadPool::setup() {
 #endif
    // init other threads (for main see below)
    while (size() < DynamicConfig::threads) {
-      push_back(std::unique_ptr<Searcher>(new Searcher(size())));
+      push_back(std::unique_ptr<Searcher>(new (size(), DynamicConfig::threads) Searcher(size())));
       back()->initPawnTable();
       back()->clearGame();
    }
@@ -68,6 +68,7 @@ void ThreadPool::distributeData(const ThreadData& data) const {
 
 // distribute data and call main thread search (this is a non-blocking function)
 void ThreadPool::startSearch(const ThreadData& data) {
+   startSearchTime = Clock::now();
    Logging::LogIt(Logging::logInfo) << "Search Sync";
    main().wait();
    // COM state must be updated quite late, when all threads or done
@@ -80,6 +81,10 @@ void ThreadPool::startSearch(const ThreadData& data) {
    main().startThread(); // non blocking call
 }
 
+TimeType ThreadPool::usSinceStart() const {
+   return std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - startSearchTime).count();
+}
+
 void ThreadPool::startOthers() const {
    for (const auto& s : *this)
       if (!(*s).isMainThread()) (*s).startThread();
@@ -112,11 +117,18 @@ Counter ThreadPool::counter(Stats::StatId id, bool forceLocal) const {
    if (!forceLocal && Distributed::moreThanOneProcess()) { return Distributed::counter(id); }
    else {
       Counter n = 0;
-      for (const auto& it : *this) { n += it->stats.counters[id]; }
+      for (const auto& it : *this) { n += it->stats.snapshot(id); }
       return n;
    }
 }
 
+Counter ThreadPool::nodeCount() const {
+   if (Distributed::moreThanOneProcess()) { return Distributed::counter(Stats::sid_nodes) + Distributed::counter(Stats::sid_qnodes); }
+   Counter n = 0;
+   for (const auto& it : *this) { n += it->stats.snapshot(Stats::sid_nodes) + it->stats.snapshot(Stats::sid_qnodes); }
+   return n;
+}
+
 std::ostream& operator<<(std::ostream& of, const ThreadData& d) {
    of << GetFEN(d.p) << " " << d.score << " " << ToString(d.best) << " " << ToString(d.pv);
    return of;
@@ -68,10 +68,16 @@ class ThreadPool : public std::vector<std::unique_ptr<Searcher>> {
 
    // gathering counter information from all threads
    [[nodiscard]] Counter counter(Stats::StatId id, bool forceLocal = false) const;
+   // nodes + qnodes of all threads in one pass (used for node limits and GUI output)
+   [[nodiscard]] Counter nodeCount() const;
 
    void displayStats() const;
    void clearGame() const;
    void clearSearch() const;
 
+   // start latency (from startSearch call), for logging
+   [[nodiscard]] TimeType usSinceStart() const;
+
    TimeType currentMoveMs = 999;
+   std::chrono::time_point<Clock> startSearchTime;
 };
@@ -1,5 +1,6 @@
 #include "transposition.hpp"
 
+#include "allocator.hpp"
 #include "distributed.h"
 #include "dynamicConfig.hpp"
 #include "logging.hpp"
@@ -9,48 +10,61 @@
 
 namespace {
 
-template<class T> struct DeleteAligned {
-   void operator()(T *ptr) const {
-      if (ptr) std_aligned_free(ptr);
-   }
-};
+uint64_t ttSize = 0; // number of buckets
+std::unique_ptr<TT::Bucket[], Allocator::DeleteAligned<TT::Bucket>> table(nullptr);
+
+[[nodiscard]] FORCE_FINLINE TT::Bucket & getBucket(const Hash h) { return table[h & (ttSize - 1)]; }
 
-uint64_t ttSize = 0;
-std::unique_ptr<TT::Entry[], DeleteAligned<TT::Entry>> table(nullptr);
+// the stored hash is xored with the data to detect (rare) torn writes between threads
+[[nodiscard]] FORCE_FINLINE bool sameKey(const TT::Entry & e, const MiniHash h) { return (e.h ^ e._data1 ^ e._data2) == h; }
+
+[[nodiscard]] FORCE_FINLINE GenerationType entryAge(const TT::Entry & e) {
+   return static_cast<GenerationType>((TT::curGen - ((e.b & TT::B_gen) >> 5)) & 7); // see Bound::B_gen
+}
+
+// lower is a better candidate for replacement : shallow and old entries first
+[[nodiscard]] FORCE_FINLINE int replacementValue(const TT::Entry & e) { return e.d - 8 * entryAge(e); }
+
+// same key entry is reused, then empty one, then the least valuable one
+[[nodiscard]] TT::Entry & getReplacementEntry(TT::Bucket & bucket, const MiniHash h) {
+   TT::Entry * victim = &bucket.e[0];
+   for (auto & e : bucket.e) {
+      if (e.h == nullHash || sameKey(e, h)) return e;
+      if (replacementValue(e) < replacementValue(*victim)) victim = &e;
+   }
+   return *victim;
+}
 
 } // namespace
 namespace TT {
 
 GenerationType curGen = 0;
 
-#ifdef __linux__
-#include <sys/mman.h>
-#endif
-
 void initTable() {
    Logging::LogIt(Logging::logInfo) << "Init TT";
    Logging::LogIt(Logging::logInfo) << "Entry size " << sizeof(Entry);
-   ttSize = powerFloor((SIZE_MULTIPLIER * DynamicConfig::ttSizeMb) / sizeof(Entry));
+   Logging::LogIt(Logging::logInfo) << "Bucket size " << sizeof(Bucket) << " (" << nbEntryPerBucket << " entries)";
+   ttSize = powerFloor((SIZE_MULTIPLIER * DynamicConfig::ttSizeMb) / sizeof(Bucket));
    assert(BB::countBit(ttSize) == 1); // a power of 2
-   table.reset((Entry *)std_aligned_alloc(1024, ttSize * sizeof(Entry)));
-   Logging::LogIt(Logging::logInfo) << "Size of TT " << ttSize * sizeof(Entry) / 1024 / 1024 << "Mb";
+   table.reset(static_cast<Bucket *>(Allocator::alloc(ttSize * sizeof(Bucket))));
+   Logging::LogIt(Logging::logInfo) << "Size of TT " << ttSize * sizeof(Bucket) / 1024 / 1024 << "Mb (" << Allocator::mode() << ")";
    clearTT();
 }
 
 void clearTT() {
    TT::curGen = 0;
    Logging::LogIt(Logging::logInfo) << "Now zeroing TT memory using " << DynamicConfig::threads << " threads";
-   auto worker = [&](size_t begin, size_t end) { std::fill(&table[0] + begin, &table[0] + end, Entry()); };
-   threadedWork(worker, DynamicConfig::threads, ttSize);
+   Allocator::clear(table.get(), ttSize, DynamicConfig::threads, Bucket());
    Logging::LogIt(Logging::logInfo) << "... done ";
 }
 
 int hashFull() {
    unsigned int count = 0;
-   const unsigned int samples = 1023 * 64;
+   const unsigned int samples = 1023 * 64 / nbEntryPerBucket;
    for (unsigned int k = 0; k < samples; ++k)
-      if (table[(k * 67) % ttSize].h != nullHash) ++count;
-   return static_cast<int>((count * 1000) / samples);
+      for (const auto & e : table[(k * 67) % ttSize].e)
+         if (e.h != nullHash && entryAge(e) == 0) ++count;
+   return static_cast<int>((count * 1000) / (samples * nbEntryPerBucket));
 }
 
 void age() {
@@ -58,7 +72,7 @@ void age() {
 }
 
 void prefetch(Hash h) {
-   void *addr = (&table[h & (ttSize - 1)]);
+   void *addr = &getBucket(h);
 #if defined(__INTEL_COMPILER)
    __asm__("");
 #elif defined(_MSC_VER)
@@ -74,17 +88,22 @@ bool getEntry(Searcher &context, const Position &p, Hash h, DepthType d, Entry &
    assert(h != nullHash);
    assert((h & (ttSize - 1)) == (h % ttSize));
    if (DynamicConfig::disableTT) return false;
-   // update entry immediatly to avoid further race condition and invalidate it later if needed
-   e = table[h & (ttSize - 1)];
+   // scan the bucket for a matching key
+   // copy entry immediatly to avoid further race condition and invalidate it later if needed
+   const MiniHash mh = Hash64to32(h);
+   e.h = nullHash;
+   for (const auto & it : getBucket(h).e) {
+      const Entry candidate = it;
+      if (candidate.h != nullHash && sameKey(candidate, mh)) {
+         e = candidate;
+         break;
+      }
+   }
 #ifdef DEBUG_HASH_ENTRY
    e.d = randomInt<unsigned int, 666>(0, UINT32_MAX);
 #endif
    if (e.h == nullHash) return false; //early exit
-   if (
-#ifndef DEBUG_HASH_ENTRY
-       ((e.h ^ e._data1 ^ e._data2) != Hash64to32(h)) ||
-#endif
-       (isValidMove(e.m) && !isPseudoLegal(p, e.m))) {
+   if (isValidMove(e.m) && !isPseudoLegal(p, e.m)) {
       // move is filled, but wrong in this position, invalidate returned entry.
       e.h = nullHash;
       return false;
@@ -100,19 +119,30 @@ bool getEntry(Searcher &context, const Position &p, Hash h, DepthType d, Entry &
    }
 }
 
-// always replace
+// depth and age aware replacement inside the bucket
 void setEntry(Searcher &context, Hash h, Move m, ScoreType s, ScoreType eval, Bound b, DepthType d) {
    assert(h != nullHash); // can really happen in fact ... but rarely
    if (DynamicConfig::disableTT) return;
+   const MiniHash mh = Hash64to32(h);
+   Entry & slot = getReplacementEntry(getBucket(h), mh);
+   const Entry old = slot;
+   const bool sameSlot = old.h != nullHash && sameKey(old, mh);
+   // do not overwrite a deeper entry of the same position from this search, unless exact bound
+   if (sameSlot && (b & ~B_allFlags) != B_exact && d + 3 < old.d && entryAge(old) == 0) return;
+   // keep previous move if none is given for the same position
+   if (sameSlot && !isValidMove(m)) m = old.m;
    Entry e(h, m, s, eval, b, d);
    e.h ^= e._data1;
    e.h ^= e._data2;
    context.stats.incr(Stats::sid_ttInsert);
-   table[h & (ttSize - 1)] = e; // always replace (favour leaf)
+   slot = e;
    Distributed::setEntry(h, e);
 }
 
-void _setEntry(Hash h, const Entry &e) { table[h & (ttSize - 1)] = e; }
+void _setEntry(Hash h, const Entry &e) { 
+   // e.h is already xored with data, so unxored it to get the real key
+   getReplacementEntry(getBucket(h), e.h ^ e._data1 ^ e._data2) = e; 
+}
 
 void getPV(const Position &p, Searcher &context, PVList &pv) {
    TT::Entry e;
@@ -124,7 +154,7 @@ void getPV(const Position &p, Searcher &context, PVList &pv) {
    p2.resetNNUEEvaluator(p2.evaluator());
 #endif
    bool stop = false;
-   for (int k = 0; k < MAX_PLY && !stop; ++k) {
+   for (int k = 0; k < MAX_PLY && !stop && !pv.full(); ++k) {
       if (!TT::getEntry(context, p2, computeHash(p2), 0, e)) break;
       if (e.h != nullHash) {
          hashStack[k] = computeHash(p2);
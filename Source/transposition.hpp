@@ -6,11 +6,11 @@ struct Position;
 struct Searcher;
 
 /*!
- * TT in Minic is a very classic 1 entry per bucket cache,
+ * TT in Minic is a bucketed cache, each bucket is a cache line holding a few entries
  * It stores a 32 bits hash and thus move from TT must be validating before being used
  * An entry is storing both static and evaluation score
  * as well as move, bound and depth.
- * ///@todo test using aging !
+ * Replacement inside a bucket is depth and age (generation) aware.
  */
 namespace TT {
 
@@ -67,6 +67,15 @@ struct Entry {
 #pragma GCC diagnostic pop
 #endif // defined(__GNUC__)
 
+// 5 entries of 12 bytes + padding fit inside a 64 bytes cache line
+inline constexpr int nbEntryPerBucket = 5;
+
+struct alignas(64) Bucket {
+   array1d<Entry, nbEntryPerBucket> e;
+   char padding[64 - nbEntryPerBucket * sizeof(Entry)];
+};
+static_assert(sizeof(Bucket) == 64, "TT bucket shall fit a cache line");
+
 [[nodiscard]] ScoreType createHashScore(ScoreType score, DepthType height);
 
 [[nodiscard]] ScoreType adjustHashScore(ScoreType score, DepthType height);
@@ -68,6 +68,11 @@ LIBS="-lpthread -ldl"
 # -lopenblas"
 
 OPT="$WARN $d $OPT $t $STDVERSION -fno-exceptions"
+if [ -n "$CPUDISPATCH" ]; then
+   echo "***** with run-time CPU dispatch *****"
+   # use a generic target (for instance -march=x86-64), simd kernels, pext and popcount are selected at startup
+   OPT="$OPT -DWITH_CPU_DISPATCH"
+fi
 if [ -n "$FORCEDNAME" ]; then
    OPT="$OPT -ffp-contract=off" # to ensure reproductible result in AVX2 (FMA)
 fi
@@ -14,7 +14,7 @@ echo "====================================="
 #   exe_name version arch_target special_options special_definitions
 
 # Intel main arch
-for m in -march=core2 -march=nehalem -march=sandybridge -march=skylake; do
+for m in -march=core2 -march=nehalem -march=sandybridge -march=skylake -march=icelake-server; do
    $dir/build.sh $e $v $m $n $d
    $dir/buildGW.sh $e $v $m $n $d
 done
@@ -27,6 +27,9 @@ for m in -march=athlon64-sse3 -march=barcelona -march=bdver1 -march=znver1 -marc
 done
 export NOPROFILE
 
+# one generic Linux x64 binary, selecting simd kernels, pext and popcount at run time
+CPUDISPATCH=1 $dir/build.sh $e $v -march=x86-64 $n $d
+
 # an old win32 build
 $dir/buildGW32.sh $e $v "-march=pentium2" $n $d
 
@@ -50,6 +53,10 @@ echo '-------'
 $buildDir/minic_${v}_linux_x64_sandybridge bench 16 -NNUEFile $net 2>&1 | grep NODES
 echo '-------'
 $buildDir/minic_${v}_linux_x64_skylake bench 16 -NNUEFile $net 2>&1 | grep NODES
+echo '-------'
+$buildDir/minic_${v}_linux_x64_icelake-server bench 16 -NNUEFile $net 2>&1 | grep NODES
+echo '-------'
+$buildDir/minic_${v}_linux_x64_x86-64 bench 16 -NNUEFile $net 2>&1 | grep NODES
 
 echo '---------------------------------'
 
@@ -60,3 +67,5 @@ echo '-------'
 $buildDir/minic_${v}_linux_x64_sandybridge bench 16 2>&1 | grep NODES
 echo '-------'
 $buildDir/minic_${v}_linux_x64_skylake bench 16 2>&1 | grep NODES
+echo '-------'
+$buildDir/minic_${v}_linux_x64_icelake-server bench 16 2>&1 | grep NODES
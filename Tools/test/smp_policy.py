@@ -0,0 +1,106 @@
+#!/usr/bin/env python3
+# Thread scaling benchmark for Minic helper threads scheduling (SMPPolicy option)
+#
+# For each policy and each thread count, on a set of positions:
+#  - fixed depth search : time to depth (speedup against 1 thread) and nps
+#  - fixed time search  : reached depth and best move agreement with a deeper
+#                         single thread reference search (used as an Elo proxy)
+#
+# usage : python3 smp_policy.py --engine ./minic --threads 1,2,4,8 --policies static,depthCount --depth 16 --time 5
+
+from subprocess import Popen, PIPE, STDOUT
+import argparse
+import time
+
+positions = [
+   "r3k2r/2pb1ppp/2pp1q2/p7/1nP1B3/1P2P3/P2N1PPP/R2QK2R w KQkq a6 0 14",
+   "4rrk1/2p1b1p1/p1p3q1/4p3/2P2n1p/1P1NR2P/PB3PP1/3R1QK1 b - - 2 24",
+   "r3qbrk/6p1/2b2pPp/p3pP1Q/PpPpP2P/3P1B2/2PB3K/R5R1 w - - 16 42",
+   "6k1/1R3p2/6p1/2Bp3p/3P2q1/P7/1P2rQ1K/5R2 b - - 4 44",
+   "8/8/1p2k1p1/3p3p/1p1P1P1P/1P2PK2/8/8 w - - 3 54",
+   "7r/2p3k1/1p1p1qp1/1P1Bp3/p1P2r1P/P7/4R3/Q4RK1 w - - 0 36",
+   "r1bq1rk1/pp2b1pp/n1pp1n2/3P1p2/2P1p3/2N1P2N/PP2BPPP/R1BQ1RK1 b - - 2 10",
+   "3r3k/2r4p/1p1b3q/p4P2/P2Pp3/1B2P3/3BQ1RP/6K1 w - - 3 87",
+]
+
+# forced flush after print
+def displ(l):
+    print(l, flush=True)
+
+def search(engine, fen, threads, policy, hash, depth=None, st=None):
+    """ run one xboard search, returns (last depth, seconds, nodes, best move) """
+    cmd = [engine, '-xboard', '-threads', str(threads), '-smpPolicy', policy, '-ttSizeMb', str(hash)]
+    p = Popen(cmd, stdin=PIPE, stdout=PIPE, stderr=STDOUT, encoding='utf8')
+    limit = 'sd {}'.format(depth) if depth else 'st {}'.format(st)
+    p.stdin.write('xboard\nprotover 2\nnew\nforce\nsetboard {}\n{}\npost\ngo\n'.format(fen, limit))
+    p.stdin.flush()
+    lastDepth, cs, nodes, best = 0, 0, 0, None
+    while True:
+        l = p.stdout.readline()
+        if not l:
+            break
+        tokens = l.split()
+        if not tokens:
+            continue
+        if tokens[0] == 'move':
+            best = tokens[1]
+            break
+        # post output is "depth score time(cs) nodes ... pv"
+        if len(tokens) >= 4 and tokens[0].isdigit() and tokens[2].isdigit() and tokens[3].isdigit():
+            lastDepth, cs, nodes = int(tokens[0]), int(tokens[2]), int(tokens[3])
+    p.stdin.write('quit\n')
+    p.stdin.flush()
+    p.wait()
+    return lastDepth, cs / 100., nodes, best
+
+def main():
+    parser = argparse.ArgumentParser()
+    parser.add_argument('--engine', default='./minic')
+    parser.add_argument('--threads', default='1,2,4,8', help='comma separated thread counts')
+    parser.add_argument('--policies', default='static,depthCount', help='comma separated SMPPolicy values')
+    parser.add_argument('--depth', type=int, default=16, help='fixed depth for time to depth')
+    parser.add_argument('--time', type=int, default=5, help='seconds per position for fixed time search')
+    parser.add_argument('--refdepth', type=int, default=None, help='reference single thread depth (default depth+4, 0 to skip)')
+    parser.add_argument('--hash', type=int, default=256)
+    parser.add_argument('--epd', default=None, help='optional position file (one fen per line)')
+    args = parser.parse_args()
+
+    fens = positions
+    if args.epd:
+        with open(args.epd) as f:
+            fens = [' '.join(l.split()[:6]) for l in f if l.strip()]
+
+    threads = [int(t) for t in args.threads.split(',')]
+    policies = args.policies.split(',')
+    refdepth = args.depth + 4 if args.refdepth is None else args.refdepth
+
+    refs = []
+    if refdepth > 0 and args.time > 0:
+        displ('Reference moves (1 thread, depth {})'.format(refdepth))
+        for fen in fens:
+            refs.append(search(args.engine, fen, 1, 'static', args.hash, depth=refdepth)[3])
+
+    baseline = None
+    displ('{:>12} {:>7} {:>10} {:>8} {:>8} {:>10} {:>9}'.format('policy', 'threads', 'ttd(s)', 'speedup', 'knps', 'depth@st', 'agree(%)'))
+    for policy in policies:
+        for t in threads:
+            ttd, nodes = 0., 0
+            for fen in fens:
+                _, s, n, _ = search(args.engine, fen, t, policy, args.hash, depth=args.depth)
+                ttd += s
+                nodes += n
+            reached, agree = 0, 0
+            if args.time > 0:
+                for k, fen in enumerate(fens):
+                    d, _, _, best = search(args.engine, fen, t, policy, args.hash, st=args.time)
+                    reached += d
+                    if refs and best == refs[k]:
+                        agree += 1
+            if baseline is None:
+                baseline = ttd
+            displ('{:>12} {:>7} {:>10.2f} {:>8.2f} {:>8.0f} {:>10.2f} {:>9.1f}'.format(
+                policy, t, ttd, baseline / max(ttd, 0.01), nodes / max(ttd, 0.01) / 1000.,
+                reached / len(fens), 100. * agree / len(fens) if refs else 0.))
+
+if __name__ == '__main__':
+    main()